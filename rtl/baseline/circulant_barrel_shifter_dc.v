@@ -0,0 +1,254 @@
+// Dual-clock variant of circulant_barrel_shifter_v2
+// Rows are written on wclk and transposed rows are read on rclk, so the producer and consumer don't
+// have to be rate-matched. The BRAMs hold two tile buffers (ping-pong): the write side fills one while
+// the read side drains the other, and finished tiles are handed between the domains with toggle flags
+// through two-flop synchronizers. Only the plain transpose is supported (no perm_mode, sparse or
+// accumulate modes).
+//
+// Write side: write the rows of a tile while wready is high, and raise wtile_done with (or after) the
+// last row. Read side: while rtile_valid is high a complete tile can be read, and rtile_done with (or
+// after) the last read gives its buffer back.
+
+module circulant_barrel_shifter_dc #(
+    parameter MATRIX_DIM = 4, //Assume square
+    parameter MEM_WIDTH = 8,
+    parameter ROW_WIDTH = MATRIX_DIM * MEM_WIDTH,
+    parameter ADDR_LEN = $clog2(MATRIX_DIM)
+)(
+    // Write domain
+    input wire wclk,
+    input wire [ROW_WIDTH-1:0] wdata,
+    input wire wen,
+    input wire [ADDR_LEN-1:0] waddr,
+    input wire wtile_done,               // Hand the tile being written to the read side
+    output wire wready,                  // A tile buffer is free to be written
+
+    // Read domain
+    input wire rclk,
+    input wire ren,
+    input wire [ADDR_LEN-1:0] rTransAddr,
+    input wire rtile_done,               // Give the tile being read back to the write side
+    output wire rtile_valid,             // A complete tile is available to read
+
+    output reg [ROW_WIDTH-1:0] rTransData,
+    output reg rTransValid
+);
+
+// bram_mem_dc latencies: registered inputs then the array write, registered address then registered data
+localparam BRAM_WRITE_LATENCY = 2;
+localparam BRAM_READ_LATENCY = 2;
+// Handoffs are delayed until the accesses before them reach the array:
+// a tile is published once its last row is written, and released once its last read sampled the array
+localparam PUBLISH_DELAY = BRAM_WRITE_LATENCY;
+localparam RELEASE_DELAY = 1 + BRAM_READ_LATENCY;   // bank address register, then the BRAM
+
+// Wires to interface with BRAM modules. The top address bit selects the tile buffer.
+reg [MEM_WIDTH-1:0] bram_wdata [0:MATRIX_DIM-1];
+reg [ADDR_LEN:0] bram_waddr [0:MATRIX_DIM-1];
+reg bram_wen [0:MATRIX_DIM-1];
+reg [ADDR_LEN:0] bram_raddr [0:MATRIX_DIM-1];
+reg bram_ren [0:MATRIX_DIM-1];
+wire [MEM_WIDTH-1:0] bram_rdata [0:MATRIX_DIM-1];
+
+// Generate BRAM instances
+genvar mem_idx;
+generate
+    for (mem_idx = 0; mem_idx < MATRIX_DIM; mem_idx = mem_idx + 1) begin : bram_gen
+        // Each column is a separate BRAM instance, deep enough for both tile buffers
+        bram_mem_dc #(
+            .DATAW(MEM_WIDTH),
+            .DEPTH(2 * MATRIX_DIM),
+            .ADDRW(ADDR_LEN + 1)
+        ) bram_inst (
+            .wclk(wclk),
+            .wdata(bram_wdata[mem_idx]),
+            .waddr(bram_waddr[mem_idx]),
+            .wen(bram_wen[mem_idx]),
+            .rclk(rclk),
+            .ren(bram_ren[mem_idx]),
+            .raddr(bram_raddr[mem_idx]),
+            .rdata(bram_rdata[mem_idx])
+        );
+    end
+endgenerate
+
+// Generate circulant col addr
+function [ADDR_LEN-1:0] circ_col_addr(
+    input [ADDR_LEN-1:0] addr, //ie starting row
+    input [ADDR_LEN-1:0] chunk_idx);
+    begin
+        reg [ADDR_LEN:0] temp_addr; // temp_addr needs to be wide enough to handle overflow
+        temp_addr = addr + chunk_idx;
+        circ_col_addr = (temp_addr >= MATRIX_DIM) ?
+                        (temp_addr - (MATRIX_DIM)) : temp_addr;
+    end
+endfunction
+
+// Tile buffer state. Buffer b holds a tile when w_fill_tgl[b] != r_free_tgl[b]; each flag is only
+// written in its own domain and seen by the other one through a synchronizer.
+reg [1:0] w_fill_tgl, r_free_tgl;
+(* ASYNC_REG = "TRUE" *) reg [1:0] free_sync_w1, free_sync_w2;   // r_free_tgl in wclk
+(* ASYNC_REG = "TRUE" *) reg [1:0] fill_sync_r1, fill_sync_r2;   // w_fill_tgl in rclk
+
+initial begin
+    w_fill_tgl = 2'b00;
+    r_free_tgl = 2'b00;
+    free_sync_w1 = 2'b00;
+    free_sync_w2 = 2'b00;
+    fill_sync_r1 = 2'b00;
+    fill_sync_r2 = 2'b00;
+end
+
+// =============== WRITE DOMAIN ===============
+
+reg [ROW_WIDTH-1:0] r_wdata;
+reg [ADDR_LEN-1:0] r_waddr;
+reg r_wen, r_wtile_done;
+reg w_sel;                                   // Buffer being written
+reg publish_pipe [0:PUBLISH_DELAY-1];        // Tiles on their way to being published
+reg publish_buf_pipe [0:PUBLISH_DELAY-1];
+
+integer w_chunk_idx, w_stage;
+
+initial begin
+    r_wen = 1'b0;
+    r_wtile_done = 1'b0;
+    w_sel = 1'b0;
+    for (w_stage = 0; w_stage < PUBLISH_DELAY; w_stage = w_stage + 1) begin
+        publish_pipe[w_stage] = 1'b0;
+    end
+end
+
+always @(posedge wclk) begin
+    r_wdata <= wdata;
+    r_waddr <= waddr;
+    r_wen <= wen;
+    r_wtile_done <= wtile_done;
+
+    free_sync_w1 <= r_free_tgl;
+    free_sync_w2 <= free_sync_w1;
+
+    // The next write goes to the other buffer, the finished one is published once its rows landed
+    if (r_wtile_done) w_sel <= ~w_sel;
+    publish_pipe[0] <= r_wtile_done;
+    publish_buf_pipe[0] <= w_sel;
+    for (w_stage = 1; w_stage < PUBLISH_DELAY; w_stage = w_stage + 1) begin
+        publish_pipe[w_stage] <= publish_pipe[w_stage-1];
+        publish_buf_pipe[w_stage] <= publish_buf_pipe[w_stage-1];
+    end
+    if (publish_pipe[PUBLISH_DELAY-1]) begin
+        w_fill_tgl[publish_buf_pipe[PUBLISH_DELAY-1]] <= ~w_fill_tgl[publish_buf_pipe[PUBLISH_DELAY-1]];
+    end
+end
+
+// Distribute the row to the BRAMs, same circulant layout as circulant_barrel_shifter_v2
+always @(*) begin
+    reg [ADDR_LEN-1:0] circ_wmem;
+    for (w_chunk_idx = 0; w_chunk_idx < MATRIX_DIM; w_chunk_idx = w_chunk_idx + 1) begin
+        circ_wmem = circ_col_addr(r_waddr, w_chunk_idx);
+        bram_waddr[circ_wmem] = {w_sel, r_waddr};
+        bram_wdata[circ_wmem] = r_wdata[(w_chunk_idx * MEM_WIDTH) +: MEM_WIDTH];
+        bram_wen[circ_wmem] = r_wen;
+    end
+end
+
+// The buffer the next write goes to must be empty, and not a tile that is still being published
+reg w_target_busy;
+integer w_check;
+always @(*) begin
+    reg w_target;
+    w_target = r_wtile_done ? ~w_sel : w_sel;
+    w_target_busy = (w_fill_tgl[w_target] != free_sync_w2[w_target]);
+    for (w_check = 0; w_check < PUBLISH_DELAY; w_check = w_check + 1) begin
+        if (publish_pipe[w_check] && publish_buf_pipe[w_check] == w_target) w_target_busy = 1'b1;
+    end
+end
+assign wready = !w_target_busy;
+
+// =============== READ DOMAIN ===============
+
+reg [ADDR_LEN-1:0] r_rTransAddr;
+reg r_ren, r_rtile_done;
+reg r_sel;                                   // Buffer being read
+reg release_pipe [0:RELEASE_DELAY-1];        // Tiles on their way to being released
+reg release_buf_pipe [0:RELEASE_DELAY-1];
+reg [ADDR_LEN-1:0] rd_addr_pipe [0:BRAM_READ_LATENCY];
+reg rd_valid_pipe [0:BRAM_READ_LATENCY];
+
+integer rchunk_idx, r_stage;
+reg [ADDR_LEN-1:0] circ_rmem;
+
+initial begin
+    r_ren = 1'b0;
+    r_rtile_done = 1'b0;
+    r_sel = 1'b0;
+    rTransValid = 1'b0;
+    for (r_stage = 0; r_stage < RELEASE_DELAY; r_stage = r_stage + 1) begin
+        release_pipe[r_stage] = 1'b0;
+    end
+    for (r_stage = 0; r_stage <= BRAM_READ_LATENCY; r_stage = r_stage + 1) begin
+        rd_valid_pipe[r_stage] = 1'b0;
+    end
+end
+
+always @(posedge rclk) begin
+    r_rTransAddr <= rTransAddr;
+    r_ren <= ren;
+    r_rtile_done <= rtile_done;
+
+    fill_sync_r1 <= w_fill_tgl;
+    fill_sync_r2 <= fill_sync_r1;
+
+    // Element j of transposed row k is stored element (j, k)
+    for (rchunk_idx = 0; rchunk_idx < MATRIX_DIM; rchunk_idx = rchunk_idx + 1) begin
+        circ_rmem = circ_col_addr(rchunk_idx, r_rTransAddr);
+        bram_raddr[circ_rmem] <= {r_sel, rchunk_idx[ADDR_LEN-1:0]};
+        bram_ren[circ_rmem] <= r_ren;
+    end
+
+    // Reads after the release go to the other buffer, the finished one is released once its
+    // reads sampled the BRAMs
+    if (r_rtile_done) r_sel <= ~r_sel;
+    release_pipe[0] <= r_rtile_done;
+    release_buf_pipe[0] <= r_sel;
+    for (r_stage = 1; r_stage < RELEASE_DELAY; r_stage = r_stage + 1) begin
+        release_pipe[r_stage] <= release_pipe[r_stage-1];
+        release_buf_pipe[r_stage] <= release_buf_pipe[r_stage-1];
+    end
+    if (release_pipe[RELEASE_DELAY-1]) begin
+        r_free_tgl[release_buf_pipe[RELEASE_DELAY-1]] <= ~r_free_tgl[release_buf_pipe[RELEASE_DELAY-1]];
+    end
+
+    // Carry the request down the pipeline with the BRAM access
+    rd_addr_pipe[0] <= r_rTransAddr;
+    rd_valid_pipe[0] <= r_ren;
+    for (r_stage = 1; r_stage <= BRAM_READ_LATENCY; r_stage = r_stage + 1) begin
+        rd_addr_pipe[r_stage] <= rd_addr_pipe[r_stage-1];
+        rd_valid_pipe[r_stage] <= rd_valid_pipe[r_stage-1];
+    end
+end
+
+// Handle collecting read data from mems
+always @(posedge rclk) begin
+    reg [ADDR_LEN-1:0] circ_rCollectMem;
+    for (rchunk_idx = 0; rchunk_idx < MATRIX_DIM; rchunk_idx = rchunk_idx + 1) begin
+        circ_rCollectMem = circ_col_addr(rchunk_idx, rd_addr_pipe[BRAM_READ_LATENCY]);
+        rTransData[(rchunk_idx * MEM_WIDTH) +: MEM_WIDTH] <= bram_rdata[circ_rCollectMem];
+    end
+    rTransValid <= rd_valid_pipe[BRAM_READ_LATENCY];
+end
+
+// The buffer the next read comes from must hold a published tile that isn't being released
+reg r_target_full;
+integer r_check;
+always @(*) begin
+    reg r_target;
+    r_target = r_rtile_done ? ~r_sel : r_sel;
+    r_target_full = (fill_sync_r2[r_target] != r_free_tgl[r_target]);
+    for (r_check = 0; r_check < RELEASE_DELAY; r_check = r_check + 1) begin
+        if (release_pipe[r_check] && release_buf_pipe[r_check] == r_target) r_target_full = 1'b0;
+    end
+end
+assign rtile_valid = r_target_full;
+
+endmodule
\ No newline at end of file
@@ -3,7 +3,34 @@ module circulant_barrel_shifter_v2 #(
     parameter MATRIX_DIM = 4, //Assume square
     parameter MEM_WIDTH = 8,
     parameter ROW_WIDTH = MATRIX_DIM * MEM_WIDTH, 
-    parameter ADDR_LEN = $clog2(MATRIX_DIM)
+    parameter ADDR_LEN = $clog2(MATRIX_DIM),
+
+    // Banking and permutation configuration
+    // Element (row, col) is stored in BRAM (col + SKEW_STRIDE * row) mod MATRIX_DIM at address row.
+    // Any SKEW_STRIDE coprime with MATRIX_DIM keeps rows and columns conflict-free.
+    parameter SKEW_STRIDE = 1,
+    parameter BLOCK_DIM = 2,              // Sub-block size for PERM_BLOCK_TRANSPOSE, must divide MATRIX_DIM
+    parameter TRANSPOSE_STRIDE = 1,       // Column stride for PERM_STRIDED_TRANSPOSE, coprime with MATRIX_DIM
+    parameter RUNTIME_PERM = 1,           // 1: perm_mode selects the permutation per read, 0: always DEFAULT_PERM
+    parameter DEFAULT_PERM = 0,
+
+    // bram_mem pipeline registers (see rtl/common/bram_mem.v). Read results and rTransValid move
+    // earlier by one cycle for each register turned off.
+    parameter BRAM_REG_INPUTS = 1,
+    parameter BRAM_REG_OUTPUT = 1,
+
+    // Track which stored rows are all zero. All-zero rows aren't written to the BRAMs, and reads
+    // return zero for their elements without reading the BRAMs that hold them. Off by default, so the
+    // engine behaves as before unless asked for it (the Makefile turns it on for the testbench).
+    parameter SPARSE_SKIP = 0,
+
+    // Accumulate writes (wacc) add the incoming row to the stored one, element by element as unsigned
+    // MEM_WIDTH values. 0: wrap around on overflow, 1: saturate at the largest value.
+    parameter ACC_SATURATE = 0,
+
+    // Simulation only: BRAM i loads its contents with $readmemh from BRAM_INIT_PREFIX_<i>.hex (i as 3
+    // digits, stored layout as in bank_of). Every row counts as nonzero then. "" starts all zero.
+    parameter BRAM_INIT_PREFIX = ""
 )(
     input wire clk,
 
@@ -11,26 +38,105 @@ module circulant_barrel_shifter_v2 #(
     input wire [ROW_WIDTH-1:0] wdata,
     input wire wen,
     input wire [ADDR_LEN-1:0] waddr, // base row addr 
+    input wire tile_clear,           // Mark every stored row as zero (start of a new tile). A write in the same
+                                     // cycle still lands. Only supported with SPARSE_SKIP.
+    input wire wacc,                 // With wen: add wdata to the stored row instead of overwriting it
+    output wire acc_busy,            // Accumulates in flight. Wait for this to drop before issuing reads,
+                                     // plain writes or tile_clear after an accumulate.
 
     // Read interface
     input wire ren,
     input wire [ADDR_LEN-1:0] rTransAddr, // base row addr
+    input wire [2:0] perm_mode,           // Permutation used for this read (see PERM_* below)
     
-    output reg [ROW_WIDTH-1:0] rTransData
+    output reg [ROW_WIDTH-1:0] rTransData,
+    output reg rTransValid,               // rTransData holds the result of a read
+
+    // Activity counters for the energy model, summed over all BRAM instances.
+    // Each BRAM is a separate physical block, so every bank access drives a full wordline.
+    output reg [31:0] wl_activations,
+    output reg [31:0] bitlines_sensed,
+    output reg [31:0] cells_written
 );
 
+// Supported read permutations. Output row k, element j of each mode reads stored element:
+localparam PERM_TRANSPOSE = 3'd0;           // (j, k)
+localparam PERM_BLOCK_TRANSPOSE = 3'd1;     // Transpose of each BLOCK_DIM x BLOCK_DIM sub-block in place
+localparam PERM_ROTATE = 3'd2;              // (MATRIX_DIM-1-j, k), a 90 degree corner turn
+localparam PERM_STRIDED_TRANSPOSE = 3'd3;   // (j, k*TRANSPOSE_STRIDE mod MATRIX_DIM), transposed rows in stride order
+localparam PERM_ROW = 3'd4;                 // (k, j), the stored row in its original orientation with the skew undone
+
+// bram_mem read latency: optional address register, then optional data register
+localparam BRAM_READ_LATENCY = BRAM_REG_INPUTS + BRAM_REG_OUTPUT;
+// bram_mem write latency: optional input registers, then the array write
+localparam BRAM_WRITE_LATENCY = BRAM_REG_INPUTS + 1;
+
+// Write/read ordering. Counting clock edges from the one that samples wen/ren:
+//   write: r_wen, then BRAM_WRITE_LATENCY edges until the array holds the row
+//   read:  r_ren, then bram_raddr, then the bram_mem address register (if any), then the edge that
+//          captures the array output (bram_mem's output register, or the collect stage without it)
+// The read samples the array exactly one edge after a write issued in the same cycle commits, so
+//   - a read issued in the same cycle as a row write, or later, already sees that row (no RAW bubble)
+//   - a write issued the cycle after a read commits on the edge the read samples, so the read still
+//     gets the old data (no WAR bubble)
+// and tiles can be written and read back to back without forwarding logic. The count relies on the
+// bram_mem latencies above; keep them in sync with bram_mem's registers.
+
 // Registers for clocking the input signals
 reg [ROW_WIDTH-1:0] r_wdata;
 reg [ADDR_LEN-1:0] r_waddr, r_rTransAddr;
-reg r_wen, r_ren;
+reg [2:0] r_perm;
+reg r_wen, r_ren, r_tile_clear, r_wacc;
+
+// Zero bitmap: bit r is set when stored row r holds a nonzero element
+reg [MATRIX_DIM-1:0] row_nonzero;
+// Bitmap including the write/clear currently going to the BRAMs. Reads use this one, so a read issued
+// with or after a row write sees that row's new state (same ordering as the BRAM data itself).
+reg [MATRIX_DIM-1:0] row_nonzero_next;
+
+// Read request travelling alongside the BRAM access, so the collect stage rotates with the
+// address/permutation of the read that produced the data (one read can be issued per cycle)
+reg [ADDR_LEN-1:0] rd_addr_pipe [0:BRAM_READ_LATENCY];
+reg [2:0] rd_perm_pipe [0:BRAM_READ_LATENCY];
+reg rd_valid_pipe [0:BRAM_READ_LATENCY];
+reg [MATRIX_DIM-1:0] rd_zero_pipe [0:BRAM_READ_LATENCY]; // Output elements whose source row is all zero
+
+// Accumulate read-modify-write. The stored row is read through the BRAM read ports like a row-order
+// read, travels down the same pipeline, and the sum is written back when the BRAM data arrives.
+reg acc_valid_pipe [0:BRAM_READ_LATENCY];
+reg [ADDR_LEN-1:0] acc_row_pipe [0:BRAM_READ_LATENCY];
+reg [ROW_WIDTH-1:0] acc_data_pipe [0:BRAM_READ_LATENCY];
+reg acc_zero_pipe [0:BRAM_READ_LATENCY];   // Stored row is all zero, its BRAMs weren't read
+// Write-backs that the BRAMs don't return yet: entry i was written back i+1 cycles ago.
+// An accumulate to the same row within that window takes its base from here instead.
+localparam ACC_FWD_DEPTH = (BRAM_READ_LATENCY > 0) ? BRAM_READ_LATENCY : 1;
+reg acc_fwd_valid [0:ACC_FWD_DEPTH-1];
+reg [ADDR_LEN-1:0] acc_fwd_row [0:ACC_FWD_DEPTH-1];
+reg [ROW_WIDTH-1:0] acc_fwd_data [0:ACC_FWD_DEPTH-1];
+reg [ROW_WIDTH-1:0] acc_sum;               // Row written back by the accumulate in the last stage
+wire acc_wb = acc_valid_pipe[BRAM_READ_LATENCY];
+// Adding an all-zero row leaves the stored row as it is, so it doesn't enter the pipeline
+wire acc_issue = r_wen && r_wacc && (r_wdata != {ROW_WIDTH{1'b0}});
 
 // Wires to interface with BRAM modules
 reg [MEM_WIDTH-1:0] bram_wdata [0:MATRIX_DIM-1]; 
 reg [ADDR_LEN-1:0] bram_waddr [0:MATRIX_DIM-1];
 reg bram_wen [0:MATRIX_DIM-1];
 reg [ADDR_LEN-1:0] bram_raddr [0:MATRIX_DIM-1];
+reg bram_ren [0:MATRIX_DIM-1];
 wire [MEM_WIDTH-1:0] bram_rdata [0:MATRIX_DIM-1];
 
+// File name suffix of BRAM idx's init file
+function [8*8-1:0] bram_init_suffix(input integer idx);
+    reg [7:0] hundreds, tens, ones;
+    begin
+        hundreds = "0" + (idx / 100) % 10;
+        tens = "0" + (idx / 10) % 10;
+        ones = "0" + idx % 10;
+        bram_init_suffix = {"_", hundreds, tens, ones, ".hex"};
+    end
+endfunction
+
 // Generate BRAM instances
 genvar mem_idx;
 generate
@@ -39,12 +145,17 @@ generate
         bram_mem #(
             .DATAW(MEM_WIDTH),
             .DEPTH(MATRIX_DIM),
-            .ADDRW(ADDR_LEN)
+            .ADDRW(ADDR_LEN),
+            .REG_INPUTS(BRAM_REG_INPUTS),
+            .REG_OUTPUT(BRAM_REG_OUTPUT),
+            .INIT_FILE((BRAM_INIT_PREFIX == "") ? "" : {BRAM_INIT_PREFIX, bram_init_suffix(mem_idx)}),
+            .INSTANCE_ID(mem_idx)
         ) bram_inst (
             .clk(clk),
             .wdata(bram_wdata[mem_idx]),
             .waddr(bram_waddr[mem_idx]),
             .wen(bram_wen[mem_idx]),
+            .ren(bram_ren[mem_idx]),
             .raddr(bram_raddr[mem_idx]),
             .rdata(bram_rdata[mem_idx])
         );
@@ -64,22 +175,85 @@ function [ADDR_LEN-1:0] circ_col_addr(
     end
 endfunction
 
+// BRAM holding element (row, col) of the stored tile
+function [ADDR_LEN-1:0] bank_of(
+    input [ADDR_LEN-1:0] row,
+    input [ADDR_LEN-1:0] col);
+    begin
+        bank_of = circ_col_addr(((SKEW_STRIDE * row) % MATRIX_DIM), col);
+    end
+endfunction
+
+// Source row/col of element j of permuted output row k
+function [ADDR_LEN-1:0] perm_src_row(
+    input [2:0] mode,
+    input [ADDR_LEN-1:0] k,
+    input [ADDR_LEN-1:0] j);
+    begin
+        case (mode)
+            PERM_BLOCK_TRANSPOSE: perm_src_row = (k / BLOCK_DIM) * BLOCK_DIM + (j % BLOCK_DIM);
+            PERM_ROTATE: perm_src_row = MATRIX_DIM - 1 - j;
+            PERM_ROW: perm_src_row = k;
+            default: perm_src_row = j;
+        endcase
+    end
+endfunction
+
+function [ADDR_LEN-1:0] perm_src_col(
+    input [2:0] mode,
+    input [ADDR_LEN-1:0] k,
+    input [ADDR_LEN-1:0] j);
+    begin
+        case (mode)
+            PERM_BLOCK_TRANSPOSE: perm_src_col = (j / BLOCK_DIM) * BLOCK_DIM + (k % BLOCK_DIM);
+            PERM_STRIDED_TRANSPOSE: perm_src_col = (k * TRANSPOSE_STRIDE) % MATRIX_DIM;
+            PERM_ROW: perm_src_col = j;
+            default: perm_src_col = k;
+        endcase
+    end
+endfunction
+
 // Handle writes - register input signals for write operations
 // We want to register the input signals to the circulant shift calculation for timing
 always @(posedge clk) begin
     r_wdata <= wdata;
     r_waddr <= waddr;
     r_wen <= wen;
+    r_tile_clear <= tile_clear;
+    r_wacc <= wacc;
+end
+
+initial begin
+    row_nonzero = (BRAM_INIT_PREFIX == "") ? {MATRIX_DIM{1'b0}} : {MATRIX_DIM{1'b1}};
+end
+
+always @(*) begin
+    row_nonzero_next = (SPARSE_SKIP && r_tile_clear) ? {MATRIX_DIM{1'b0}} : row_nonzero;
+    if (r_wen && !r_wacc) row_nonzero_next[r_waddr] = (r_wdata != {ROW_WIDTH{1'b0}});
+    if (acc_wb) row_nonzero_next[acc_row_pipe[BRAM_READ_LATENCY]] = (acc_sum != {ROW_WIDTH{1'b0}});
+end
+
+always @(posedge clk) begin
+    row_nonzero <= row_nonzero_next;
 end
 
-integer w_chunk_idx, j;
+integer w_chunk_idx, j, stage;
 always @(*) begin
     reg [ADDR_LEN-1:0] circ_wmem; // Handles circulant mem addressing
 
-    // Using the registered values, distribute the writes to the BRAMs
-    if (r_wen) begin
+    // Using the registered values, distribute the writes to the BRAMs.
+    // An all-zero row only updates the bitmap.
+    if (acc_wb) begin
+        // Accumulate write-back
         for (w_chunk_idx = 0; w_chunk_idx < MATRIX_DIM; w_chunk_idx = w_chunk_idx + 1) begin
-            circ_wmem = circ_col_addr(r_waddr, w_chunk_idx);
+            circ_wmem = bank_of(acc_row_pipe[BRAM_READ_LATENCY], w_chunk_idx);
+            bram_waddr[circ_wmem] = acc_row_pipe[BRAM_READ_LATENCY];
+            bram_wdata[circ_wmem] = acc_sum[(w_chunk_idx * MEM_WIDTH) +: MEM_WIDTH];
+            bram_wen[circ_wmem] = !(SPARSE_SKIP && acc_sum == {ROW_WIDTH{1'b0}});
+        end
+    end else if (r_wen && !r_wacc && !(SPARSE_SKIP && r_wdata == {ROW_WIDTH{1'b0}})) begin
+        for (w_chunk_idx = 0; w_chunk_idx < MATRIX_DIM; w_chunk_idx = w_chunk_idx + 1) begin
+            circ_wmem = bank_of(r_waddr, w_chunk_idx);
             bram_waddr[circ_wmem] = r_waddr;
             bram_wdata[circ_wmem] = r_wdata[(w_chunk_idx * MEM_WIDTH) +: MEM_WIDTH];
             bram_wen[circ_wmem] = 1'b1;
@@ -91,37 +265,186 @@ always @(*) begin
     end
 end
 
+// Add the incoming row to its base: the newest pending write-back of the row if there is one,
+// otherwise the stored row from the BRAMs
+integer acc_idx, fwd_idx;
+always @(*) begin
+    reg [ROW_WIDTH-1:0] base;
+    reg fwd_hit;
+    reg [MEM_WIDTH:0] elem_sum;
+    base = {ROW_WIDTH{1'b0}};
+    if (!acc_zero_pipe[BRAM_READ_LATENCY]) begin
+        for (acc_idx = 0; acc_idx < MATRIX_DIM; acc_idx = acc_idx + 1) begin
+            base[(acc_idx * MEM_WIDTH) +: MEM_WIDTH] = bram_rdata[bank_of(acc_row_pipe[BRAM_READ_LATENCY], acc_idx)];
+        end
+    end
+    fwd_hit = 1'b0;
+    for (fwd_idx = 0; fwd_idx < ACC_FWD_DEPTH; fwd_idx = fwd_idx + 1) begin
+        if (!fwd_hit && acc_fwd_valid[fwd_idx] && acc_fwd_row[fwd_idx] == acc_row_pipe[BRAM_READ_LATENCY]) begin
+            base = acc_fwd_data[fwd_idx];
+            fwd_hit = 1'b1;
+        end
+    end
+    for (acc_idx = 0; acc_idx < MATRIX_DIM; acc_idx = acc_idx + 1) begin
+        elem_sum = base[(acc_idx * MEM_WIDTH) +: MEM_WIDTH] + acc_data_pipe[BRAM_READ_LATENCY][(acc_idx * MEM_WIDTH) +: MEM_WIDTH];
+        acc_sum[(acc_idx * MEM_WIDTH) +: MEM_WIDTH] = (ACC_SATURATE && elem_sum[MEM_WIDTH]) ?
+                                                      {MEM_WIDTH{1'b1}} : elem_sum[MEM_WIDTH-1:0];
+    end
+end
+
+reg acc_in_flight;
+integer acc_stage;
+always @(*) begin
+    acc_in_flight = acc_issue;
+    for (acc_stage = 0; acc_stage <= BRAM_READ_LATENCY; acc_stage = acc_stage + 1) begin
+        acc_in_flight = acc_in_flight | acc_valid_pipe[acc_stage];
+    end
+end
+assign acc_busy = acc_in_flight;
+
+initial begin
+    for (fwd_idx = 0; fwd_idx < ACC_FWD_DEPTH; fwd_idx = fwd_idx + 1) begin
+        acc_fwd_valid[fwd_idx] = 1'b0;
+    end
+end
+
+always @(posedge clk) begin
+    acc_fwd_valid[0] <= acc_wb;
+    acc_fwd_row[0] <= acc_row_pipe[BRAM_READ_LATENCY];
+    acc_fwd_data[0] <= acc_sum;
+    for (fwd_idx = 1; fwd_idx < ACC_FWD_DEPTH; fwd_idx = fwd_idx + 1) begin
+        acc_fwd_valid[fwd_idx] <= acc_fwd_valid[fwd_idx-1];
+        acc_fwd_row[fwd_idx] <= acc_fwd_row[fwd_idx-1];
+        acc_fwd_data[fwd_idx] <= acc_fwd_data[fwd_idx-1];
+    end
+end
+
+// Count BRAM activity, one wordline per bank written or read. A dense row write touches every bank,
+// and so does a dense transposed read; zero rows skip theirs.
+integer count_idx;
+reg [31:0] banks_written, banks_read;
+always @(*) begin
+    banks_written = 32'd0;
+    banks_read = 32'd0;
+    for (count_idx = 0; count_idx < MATRIX_DIM; count_idx = count_idx + 1) begin
+        banks_written = banks_written + bram_wen[count_idx];
+        banks_read = banks_read + bram_ren[count_idx];
+    end
+end
+
+initial begin
+    wl_activations = 32'd0;
+    bitlines_sensed = 32'd0;
+    cells_written = 32'd0;
+end
+
+always @(posedge clk) begin
+    wl_activations <= wl_activations + banks_written + banks_read;
+    bitlines_sensed <= bitlines_sensed + banks_read * MEM_WIDTH;
+    cells_written <= cells_written + banks_written * MEM_WIDTH;
+end
+
 // Handle distributing reads to BRAMs
 // First, we want to set the read address:
 integer rchunk_idx;
 reg [ADDR_LEN-1:0] circ_rmem; // Handles circulant mem addressing
 
+initial begin
+    rTransValid = 1'b0;
+    for (rchunk_idx = 0; rchunk_idx < MATRIX_DIM; rchunk_idx = rchunk_idx + 1) begin
+        bram_ren[rchunk_idx] = 1'b0;
+    end
+    for (stage = 0; stage <= BRAM_READ_LATENCY; stage = stage + 1) begin
+        rd_valid_pipe[stage] = 1'b0;
+        acc_valid_pipe[stage] = 1'b0;
+    end
+end
+
 always @(posedge clk) begin
     r_rTransAddr <= rTransAddr;
+    r_perm <= RUNTIME_PERM ? perm_mode : DEFAULT_PERM;
     r_ren <= ren;
-    // Need to handle the start of the data being in an offset 
-    // We need to read in a diagonal pattern starting at row=0, column=r_rTransAddr 
+    // Each output element comes from a different BRAM for any conflict-free permutation,
+    // so every BRAM gets the row address of the one element it has to supply.
+    // Elements of all-zero rows are known to be zero, so their BRAMs stay idle.
     if (r_ren) begin
         for (rchunk_idx = 0; rchunk_idx < MATRIX_DIM; rchunk_idx = rchunk_idx + 1) begin
-            circ_rmem = circ_col_addr(r_rTransAddr, rchunk_idx);
-            bram_raddr[circ_rmem] <= rchunk_idx[ADDR_LEN-1:0];
+            circ_rmem = bank_of(perm_src_row(r_perm, r_rTransAddr, rchunk_idx),
+                                perm_src_col(r_perm, r_rTransAddr, rchunk_idx));
+            bram_raddr[circ_rmem] <= perm_src_row(r_perm, r_rTransAddr, rchunk_idx);
+            rd_zero_pipe[0][rchunk_idx] <= SPARSE_SKIP && !row_nonzero_next[perm_src_row(r_perm, r_rTransAddr, rchunk_idx)];
+            bram_ren[circ_rmem] <= !(SPARSE_SKIP && !row_nonzero_next[perm_src_row(r_perm, r_rTransAddr, rchunk_idx)]);
+        end
+    end else if (acc_issue) begin
+        // Accumulate: read the stored row, unless it is known to be zero
+        for (rchunk_idx = 0; rchunk_idx < MATRIX_DIM; rchunk_idx = rchunk_idx + 1) begin
+            circ_rmem = bank_of(r_waddr, rchunk_idx);
+            bram_raddr[circ_rmem] <= r_waddr;
+            bram_ren[circ_rmem] <= !(SPARSE_SKIP && !row_nonzero_next[r_waddr]);
         end
+        rd_zero_pipe[0] <= {MATRIX_DIM{1'b0}};
     end else begin
         for (rchunk_idx = 0; rchunk_idx < MATRIX_DIM; rchunk_idx = rchunk_idx + 1) begin
             bram_raddr[rchunk_idx] <= 0;
+            bram_ren[rchunk_idx] <= 1'b0;
         end
+        rd_zero_pipe[0] <= {MATRIX_DIM{1'b0}};
+    end
+
+    // Carry the request down the pipeline with the BRAM access
+    rd_addr_pipe[0] <= r_rTransAddr;
+    rd_perm_pipe[0] <= r_perm;
+    rd_valid_pipe[0] <= r_ren;
+    acc_valid_pipe[0] <= acc_issue;
+    acc_row_pipe[0] <= r_waddr;
+    acc_data_pipe[0] <= r_wdata;
+    acc_zero_pipe[0] <= SPARSE_SKIP && !row_nonzero_next[r_waddr];
+    for (stage = 1; stage <= BRAM_READ_LATENCY; stage = stage + 1) begin
+        acc_valid_pipe[stage] <= acc_valid_pipe[stage-1];
+        acc_row_pipe[stage] <= acc_row_pipe[stage-1];
+        acc_data_pipe[stage] <= acc_data_pipe[stage-1];
+        acc_zero_pipe[stage] <= acc_zero_pipe[stage-1];
+        rd_addr_pipe[stage] <= rd_addr_pipe[stage-1];
+        rd_perm_pipe[stage] <= rd_perm_pipe[stage-1];
+        rd_valid_pipe[stage] <= rd_valid_pipe[stage-1];
+        rd_zero_pipe[stage] <= rd_zero_pipe[stage-1];
     end
 end
 
 // Handle collecting read data from mems
-reg [ADDR_LEN-1:0] circ_rCollectMem;
 always @(posedge clk) begin
-    // Need to rotate left by r_rTransAddr
+    // Route each BRAM's output back to the output element it was read for
     reg [ADDR_LEN-1:0] circ_rCollectMem; // Handles circulant mem addressing
     for (rchunk_idx = 0; rchunk_idx < MATRIX_DIM; rchunk_idx = rchunk_idx + 1) begin
-        circ_rCollectMem = circ_col_addr(r_rTransAddr, rchunk_idx);
-        rTransData[(rchunk_idx * MEM_WIDTH) +: MEM_WIDTH] <= bram_rdata[circ_rCollectMem];
+        circ_rCollectMem = bank_of(perm_src_row(rd_perm_pipe[BRAM_READ_LATENCY], rd_addr_pipe[BRAM_READ_LATENCY], rchunk_idx),
+                                   perm_src_col(rd_perm_pipe[BRAM_READ_LATENCY], rd_addr_pipe[BRAM_READ_LATENCY], rchunk_idx));
+        rTransData[(rchunk_idx * MEM_WIDTH) +: MEM_WIDTH] <= rd_zero_pipe[BRAM_READ_LATENCY][rchunk_idx] ?
+                                                             {MEM_WIDTH{1'b0}} : bram_rdata[circ_rCollectMem];
     end
+    rTransValid <= rd_valid_pipe[BRAM_READ_LATENCY];
+end
+
+// Testbench backdoor (tb/backdoor.h). The BRAM contents are accessed through each bram_mem; the zero
+// bitmap has to follow what the testbench stores there, or reads would skip rows it filled.
+`ifdef TB_BACKDOOR
+import "DPI-C" context function void tb_backdoor_register(input int kind, input int index);
+export "DPI-C" function circulant_backdoor_set_row_nonzero;
+
+function void circulant_backdoor_set_row_nonzero(input int row, input bit nonzero);
+    row_nonzero[row[ADDR_LEN-1:0]] = nonzero;
+endfunction
+
+initial tb_backdoor_register(2, 0);
+`endif
+
+// Usage rules of the accumulate mode: an accumulate shares the BRAM read ports with reads, and its
+// write-back shares the write ports with plain writes
+`ifdef FORMAL
+always @(posedge clk) begin
+    assert(!(r_ren && acc_issue)) else $error("Read issued in the same cycle as an accumulate");
+    assert(!(acc_wb && r_wen && !r_wacc)) else $error("Plain write collided with an accumulate write-back");
+    assert(!(acc_wb && r_tile_clear)) else $error("tile_clear issued while accumulates were in flight");
 end
+`endif
 
 endmodule
\ No newline at end of file
@@ -14,7 +14,20 @@ module m20k_bram_core #(
     // Physical parameters from https://ieeexplore.ieee.org/document/9786179 (CoMeFa)
     parameter PHYSICAL_ROWS = 128,
     parameter PHYSICAL_COLS = 160,
-    parameter COL_MUX_FACTOR = 4          // Since widest supported width is 40 bits
+    parameter COL_MUX_FACTOR = 4,         // Since widest supported width is 40 bits
+    parameter BYTE_LANE_WIDTH = 8,        // Bits covered by each byte enable (real M20Ks use 10 in x20/x40 modes)
+
+    // Optional registers around the array. Read latency is REG_INPUTS + REG_OUTPUTS cycles.
+    // A real M20K always registers its inputs and makes the output register optional (latency 2 or 1);
+    // REG_INPUTS = 0 has no M20K equivalent and is only meant for latency experiments.
+    parameter REG_INPUTS = 1,
+    parameter REG_OUTPUTS = 1,
+
+    // Simulation only: logical words loaded with $readmemh at startup (word i on line i), "" keeps the
+    // array zero
+    parameter INIT_FILE = "",
+    // Simulation only: index the instance registers under for the testbench backdoor (TB_BACKDOOR)
+    parameter INSTANCE_ID = 0
 ) (
     input wire clk,
     input wire rst,
@@ -22,16 +35,25 @@ module m20k_bram_core #(
     // Port A
     input wire [$clog2(LOGICAL_DEPTH)-1:0] addr_a,
     input wire [LOGICAL_DATA_WIDTH-1:0] data_in_a,
+    input wire [(LOGICAL_DATA_WIDTH+BYTE_LANE_WIDTH-1)/BYTE_LANE_WIDTH-1:0] be_a, // Per-lane write enables
     input wire wen_a,
     input wire ren_a,
+    input wire burst_a,                 // Burst read: auto-increments from addr_a while held with ren_a
     output reg [LOGICAL_DATA_WIDTH-1:0] data_out_a,
     
     // Port B
     input wire [$clog2(LOGICAL_DEPTH)-1:0] addr_b,
     input wire [LOGICAL_DATA_WIDTH-1:0] data_in_b,
+    input wire [(LOGICAL_DATA_WIDTH+BYTE_LANE_WIDTH-1)/BYTE_LANE_WIDTH-1:0] be_b, // Per-lane write enables
     input wire wen_b,
     input wire ren_b,
-    output reg [LOGICAL_DATA_WIDTH-1:0] data_out_b
+    input wire burst_b,                 // Burst read: auto-increments from addr_b while held with ren_b
+    output reg [LOGICAL_DATA_WIDTH-1:0] data_out_b,
+
+    // Activity counters for the energy model (cumulative since reset)
+    output reg [31:0] wl_activations,     // Physical wordlines driven (one per port access)
+    output reg [31:0] bitlines_sensed,    // Columns read out through the sense amps
+    output reg [31:0] cells_written       // Individual bit cells written
 );
 
     // Local parameters
@@ -39,67 +61,194 @@ module m20k_bram_core #(
     localparam PHYSICAL_ADDR_WIDTH = $clog2(PHYSICAL_ROWS);
     localparam PHYSICAL_COL_WIDTH = $clog2(PHYSICAL_COLS);
     localparam LOG_TO_PHYS_BITS = PHYSICAL_COLS / LOGICAL_DATA_WIDTH;
+    // Column multiplexing: each sense amp serves COL_MUX_FACTOR adjacent columns, so the bits of a
+    // logical word are interleaved COL_MUX_FACTOR columns apart and neighbouring words share sense amps.
+    // Widths whose words-per-row isn't a multiple of the mux factor fall back to contiguous packing.
+    localparam MUX_INTERLEAVE = (LOG_TO_PHYS_BITS % COL_MUX_FACTOR == 0) ? COL_MUX_FACTOR : 1;
+    localparam NUM_LANES = (LOGICAL_DATA_WIDTH + BYTE_LANE_WIDTH - 1) / BYTE_LANE_WIDTH;
 
     // 2D array of individual SRAM cells 
     reg cell_array [0:PHYSICAL_ROWS-1][0:PHYSICAL_COLS-1];
     
     // Variables for address decoding 
     reg [PHYSICAL_ADDR_WIDTH-1:0] phys_row_a, phys_row_b;
-    reg [PHYSICAL_COL_WIDTH-1:0] col_start_a, col_start_b;
     integer bit_idx_a, bit_idx_b; // Loop variables
 
-    // Registerd inputs
+    // Registerd inputs, or the ports themselves when REG_INPUTS = 0. These are what the array sees.
     // Port A
     reg [$clog2(LOGICAL_DEPTH)-1:0] r_addr_a;
     reg [LOGICAL_DATA_WIDTH-1:0] r_data_in_a;
+    reg [NUM_LANES-1:0] r_be_a;
     reg r_wen_a;
     reg r_ren_a;
+    reg r_burst_a;
     // Port B
     reg [$clog2(LOGICAL_DEPTH)-1:0] r_addr_b;
     reg [LOGICAL_DATA_WIDTH-1:0] r_data_in_b;
+    reg [NUM_LANES-1:0] r_be_b;
     reg r_wen_b;
     reg r_ren_b;
+    reg r_burst_b;
+
+    // Burst read state per port. A burst latches a whole physical row into the port's row buffer
+    // (every column sensed at once) and serves the following sequential logical words from it,
+    // leaving the array free instead of re-activating the same wordline for each word.
+    reg row_buf_a [0:PHYSICAL_COLS-1];
+    reg row_buf_b [0:PHYSICAL_COLS-1];
+    reg [PHYSICAL_ADDR_WIDTH-1:0] row_buf_row_a, row_buf_row_b;
+    reg row_buf_valid_a, row_buf_valid_b;
+    reg burst_active_a, burst_active_b;
+    reg [ADDR_WIDTH-1:0] burst_addr_a, burst_addr_b; // Next address of an ongoing burst
+    integer col_idx_a, col_idx_b;
+
+    // Data read from the array, latched on the clock edge of each read. This is the output register,
+    // and without it the sense amps still hold the last word between reads.
+    reg [LOGICAL_DATA_WIDTH-1:0] rd_data_a, rd_data_b;
+    // Data read from the array during the current cycle, before the clock edge
+    reg [LOGICAL_DATA_WIDTH-1:0] array_out_a, array_out_b;
     
+    // Burst address and row buffer decode
+    // A burst read continues from the auto-incremented address; everything else uses the input address
+    wire burst_rd_a = r_ren_a & r_burst_a & ~r_wen_a;
+    wire [ADDR_WIDTH-1:0] eff_addr_a = (burst_rd_a & burst_active_a) ? burst_addr_a : r_addr_a;
+    wire burst_hit_a = burst_rd_a & row_buf_valid_a & (row_buf_row_a == get_phys_row(eff_addr_a));
+    wire burst_fill_a = burst_rd_a & ~burst_hit_a;
+    // Row held by the buffer after this cycle, used to keep it coherent with writes
+    wire [PHYSICAL_ADDR_WIDTH-1:0] row_buf_next_a = burst_fill_a ? get_phys_row(eff_addr_a) : row_buf_row_a;
+
+    wire burst_rd_b = r_ren_b & r_burst_b & ~r_wen_b;
+    wire [ADDR_WIDTH-1:0] eff_addr_b = (burst_rd_b & burst_active_b) ? burst_addr_b : r_addr_b;
+    wire burst_hit_b = burst_rd_b & row_buf_valid_b & (row_buf_row_b == get_phys_row(eff_addr_b));
+    wire burst_fill_b = burst_rd_b & ~burst_hit_b;
+    wire [PHYSICAL_ADDR_WIDTH-1:0] row_buf_next_b = burst_fill_b ? get_phys_row(eff_addr_b) : row_buf_row_b;
+
+    // Logical words read from INIT_FILE, scattered into the cell array by the initial block below
+    reg [LOGICAL_DATA_WIDTH-1:0] init_words [0:LOGICAL_DEPTH-1];
+
     // Initialize physical memory
     initial begin
-        integer row, col;
+        integer row, col, init_addr, init_bit;
         for (row = 0; row < PHYSICAL_ROWS; row = row + 1) begin
             for (col = 0; col < PHYSICAL_COLS; col = col + 1) begin
                 cell_array[row][col] = 1'b0;
             end
         end
-        data_out_a = {LOGICAL_DATA_WIDTH{1'b0}};
-        data_out_b = {LOGICAL_DATA_WIDTH{1'b0}};
+        if (INIT_FILE != "") begin
+            for (init_addr = 0; init_addr < LOGICAL_DEPTH; init_addr = init_addr + 1) begin
+                init_words[init_addr] = {LOGICAL_DATA_WIDTH{1'b0}};
+            end
+            $readmemh(INIT_FILE, init_words);
+            for (init_addr = 0; init_addr < LOGICAL_DEPTH; init_addr = init_addr + 1) begin
+                for (init_bit = 0; init_bit < LOGICAL_DATA_WIDTH; init_bit = init_bit + 1) begin
+                    cell_array[get_phys_row(init_addr)][get_phys_col(init_addr, init_bit)] =
+                        init_words[init_addr][init_bit];
+                end
+            end
+        end
+        rd_data_a = {LOGICAL_DATA_WIDTH{1'b0}};
+        rd_data_b = {LOGICAL_DATA_WIDTH{1'b0}};
+        wl_activations = 32'd0;
+        bitlines_sensed = 32'd0;
+        cells_written = 32'd0;
+        row_buf_valid_a = 1'b0;
+        row_buf_valid_b = 1'b0;
+        burst_active_a = 1'b0;
+        burst_active_b = 1'b0;
     end
     
+    // Input registers
+    generate
+        if (REG_INPUTS) begin : in_reg_gen
+            always @(posedge clk or posedge rst) begin
+                if (rst) begin
+                    r_addr_a <= {ADDR_WIDTH{1'b0}};
+                    r_data_in_a <= {LOGICAL_DATA_WIDTH{1'b0}};
+                    r_be_a <= {NUM_LANES{1'b0}};
+                    r_wen_a <= 1'b0;
+                    r_ren_a <= 1'b0;
+                    r_burst_a <= 1'b0;
+
+                    r_addr_b <= {ADDR_WIDTH{1'b0}};
+                    r_data_in_b <= {LOGICAL_DATA_WIDTH{1'b0}};
+                    r_be_b <= {NUM_LANES{1'b0}};
+                    r_wen_b <= 1'b0;
+                    r_ren_b <= 1'b0;
+                    r_burst_b <= 1'b0;
+                end
+                else begin
+                    r_addr_a <= addr_a;
+                    r_data_in_a <= data_in_a;
+                    r_be_a <= be_a;
+                    r_wen_a <= wen_a;
+                    r_ren_a <= ren_a;
+                    r_burst_a <= burst_a;
+
+                    r_addr_b <= addr_b;
+                    r_data_in_b <= data_in_b;
+                    r_be_b <= be_b;
+                    r_wen_b <= wen_b;
+                    r_ren_b <= ren_b;
+                    r_burst_b <= burst_b;
+                end
+            end
+        end else begin : in_comb_gen
+            // Ports drive the array directly, accesses happen on the edge that samples them
+            always @(*) begin
+                r_addr_a = addr_a;
+                r_data_in_a = data_in_a;
+                r_be_a = be_a;
+                r_wen_a = wen_a & ~rst;
+                r_ren_a = ren_a & ~rst;
+                r_burst_a = burst_a;
+
+                r_addr_b = addr_b;
+                r_data_in_b = data_in_b;
+                r_be_b = be_b;
+                r_wen_b = wen_b & ~rst;
+                r_ren_b = ren_b & ~rst;
+                r_burst_b = burst_b;
+            end
+        end
+    endgenerate
+
+    // Output registers. Without them data_out follows the array during a read, then holds.
+    generate
+        if (REG_OUTPUTS) begin : out_reg_gen
+            always @(*) begin
+                data_out_a = rd_data_a;
+                data_out_b = rd_data_b;
+            end
+        end else begin : out_comb_gen
+            always @(*) begin
+                data_out_a = r_ren_a ? array_out_a : rd_data_a;
+                data_out_b = r_ren_b ? array_out_b : rd_data_b;
+            end
+        end
+    endgenerate
+
     // Reset logic
     always @(posedge clk or posedge rst) begin
         if (rst) begin
-            // Reset outputs and registered inputs
-            data_out_a <= {LOGICAL_DATA_WIDTH{1'b0}};
-            data_out_b <= {LOGICAL_DATA_WIDTH{1'b0}};
-
-            r_addr_a <= {ADDR_WIDTH{1'b0}};
-            r_data_in_a <= {LOGICAL_DATA_WIDTH{1'b0}};
-            r_wen_a <= 1'b0;
-            r_ren_a <= 1'b0;
+            // Reset outputs and counters
+            rd_data_a <= {LOGICAL_DATA_WIDTH{1'b0}};
+            rd_data_b <= {LOGICAL_DATA_WIDTH{1'b0}};
 
-            r_addr_b <= {ADDR_WIDTH{1'b0}};
-            r_data_in_b <= {LOGICAL_DATA_WIDTH{1'b0}};
-            r_wen_b <= 1'b0;
-            r_ren_b <= 1'b0;
+            wl_activations <= 32'd0;
+            bitlines_sensed <= 32'd0;
+            cells_written <= 32'd0;
         end
         else begin
-            // Register inputs
-            r_addr_a <= addr_a;
-            r_data_in_a <= data_in_a;
-            r_wen_a <= wen_a;
-            r_ren_a <= ren_a;
-
-            r_addr_b <= addr_b;
-            r_data_in_b <= data_in_b;
-            r_wen_b <= wen_b;
-            r_ren_b <= ren_b;
+            // Count the array activity of the accesses performed this cycle.
+            // A read and a write on the same port share one wordline activation,
+            // and burst reads served from the row buffer don't touch the array.
+            wl_activations <= wl_activations + ((r_wen_a | r_ren_a) & ~burst_hit_a)
+                                             + ((r_wen_b | r_ren_b) & ~burst_hit_b);
+            bitlines_sensed <= bitlines_sensed + (burst_fill_a ? PHYSICAL_COLS : 
+                                                  (r_ren_a & ~burst_hit_a) ? LOGICAL_DATA_WIDTH : 0)
+                                               + (burst_fill_b ? PHYSICAL_COLS : 
+                                                  (r_ren_b & ~burst_hit_b) ? LOGICAL_DATA_WIDTH : 0);
+            cells_written <= cells_written + (r_wen_a ? lane_bits(r_be_a) : 0)
+                                           + (r_wen_b ? lane_bits(r_be_b) : 0);
         end
     end
     
@@ -112,43 +261,105 @@ module m20k_bram_core #(
         end
     endfunction
     
-    // Find the starting physical column for a logical word
+    // Find the physical column holding one bit of a logical word
     function [PHYSICAL_COL_WIDTH-1:0] get_phys_col;
         input [ADDR_WIDTH-1:0] logical_addr;
+        input [PHYSICAL_COL_WIDTH-1:0] bit_idx;
+        reg [PHYSICAL_COL_WIDTH-1:0] word_slot;
         begin
-            // Column start = (logical_addr % words_per_row) * logical_data_width
-            get_phys_col = (logical_addr % LOG_TO_PHYS_BITS) * LOGICAL_DATA_WIDTH;
+            // Words in a row are grouped into sets of MUX_INTERLEAVE that share the same sense amps.
+            // Bit b of a word sits under sense amp b of its set, at mux position word_slot % MUX_INTERLEAVE
+            word_slot = logical_addr % LOG_TO_PHYS_BITS;
+            get_phys_col = (word_slot / MUX_INTERLEAVE) * (LOGICAL_DATA_WIDTH * MUX_INTERLEAVE) +
+                           bit_idx * MUX_INTERLEAVE + (word_slot % MUX_INTERLEAVE);
         end
     endfunction
     
+    // Number of data bits covered by the enabled byte lanes (the last lane may be partial)
+    function [31:0] lane_bits;
+        input [NUM_LANES-1:0] be;
+        integer lane;
+        begin
+            lane_bits = 0;
+            for (lane = 0; lane < NUM_LANES; lane = lane + 1) begin
+                if (be[lane]) begin
+                    lane_bits = lane_bits + (((lane + 1) * BYTE_LANE_WIDTH > LOGICAL_DATA_WIDTH) ?
+                                             (LOGICAL_DATA_WIDTH - lane * BYTE_LANE_WIDTH) : BYTE_LANE_WIDTH);
+                end
+            end
+        end
+    endfunction
+
+    // Array read for each port
+    integer rd_bit_a, rd_bit_b;
+    always @(*) begin
+        for (rd_bit_a = 0; rd_bit_a < LOGICAL_DATA_WIDTH; rd_bit_a = rd_bit_a + 1) begin
+            if (burst_hit_a) begin
+                // Serve the word from the latched row, the array is not accessed
+                array_out_a[rd_bit_a] = row_buf_a[get_phys_col(eff_addr_a, rd_bit_a)];
+            end else if (get_phys_col(eff_addr_a, rd_bit_a) < PHYSICAL_COLS) begin
+                // Read logical data from individual physical cells
+                array_out_a[rd_bit_a] = cell_array[get_phys_row(eff_addr_a)][get_phys_col(eff_addr_a, rd_bit_a)];
+            end else begin
+                array_out_a[rd_bit_a] = 1'b0; // Default to 0 for out-of-bounds
+            end
+        end
+    end
+
+    always @(*) begin
+        for (rd_bit_b = 0; rd_bit_b < LOGICAL_DATA_WIDTH; rd_bit_b = rd_bit_b + 1) begin
+            if (burst_hit_b) begin
+                array_out_b[rd_bit_b] = row_buf_b[get_phys_col(eff_addr_b, rd_bit_b)];
+            end else if (get_phys_col(eff_addr_b, rd_bit_b) < PHYSICAL_COLS) begin
+                array_out_b[rd_bit_b] = cell_array[get_phys_row(eff_addr_b)][get_phys_col(eff_addr_b, rd_bit_b)];
+            end else begin
+                array_out_b[rd_bit_b] = 1'b0;
+            end
+        end
+    end
+
     // Port A access logic
     always @(posedge clk) begin
         if (!rst) begin
             if (r_wen_a | r_ren_a) begin
                 // Decode logical address to physical coordinates
-                phys_row_a = get_phys_row(r_addr_a);
-                col_start_a = get_phys_col(r_addr_a);
+                phys_row_a = get_phys_row(eff_addr_a);
                 
                 if (r_wen_a) begin
-                    // Write logical data to individual physical cells
+                    // Write logical data to individual physical cells, skipping disabled byte lanes
                     for (bit_idx_a = 0; bit_idx_a < LOGICAL_DATA_WIDTH; bit_idx_a = bit_idx_a + 1) begin
-                        if ((col_start_a + bit_idx_a) < PHYSICAL_COLS) begin
-                            cell_array[phys_row_a][col_start_a + bit_idx_a] <= r_data_in_a[bit_idx_a];
+                        if (r_be_a[bit_idx_a / BYTE_LANE_WIDTH] && get_phys_col(eff_addr_a, bit_idx_a) < PHYSICAL_COLS) begin
+                            cell_array[phys_row_a][get_phys_col(eff_addr_a, bit_idx_a)] <= r_data_in_a[bit_idx_a];
                         end
                     end
                 end
                 
                 if (r_ren_a) begin
-                    // Read logical data from individual physical cells
-                    for (bit_idx_a = 0; bit_idx_a < LOGICAL_DATA_WIDTH; bit_idx_a = bit_idx_a + 1) begin
-                        if ((col_start_a + bit_idx_a) < PHYSICAL_COLS) begin
-                            data_out_a[bit_idx_a] <= cell_array[phys_row_a][col_start_a + bit_idx_a];
-                        end else begin
-                            data_out_a[bit_idx_a] <= 1'b0; // Default to 0 for out-of-bounds
+                    rd_data_a <= array_out_a;
+
+                    if (burst_fill_a) begin
+                        // Latch the whole physical row for the rest of the burst
+                        for (col_idx_a = 0; col_idx_a < PHYSICAL_COLS; col_idx_a = col_idx_a + 1) begin
+                            row_buf_a[col_idx_a] <= cell_array[phys_row_a][col_idx_a];
                         end
+                        row_buf_row_a <= phys_row_a;
+                        row_buf_valid_a <= 1'b1;
                     end
                 end
             end
+
+            burst_active_a <= burst_rd_a;
+            burst_addr_a <= eff_addr_a + 1'b1;
+
+            // Drop the row buffer when either port writes the buffered row (including a write
+            // landing in the same cycle as the fill, which latched the old data)
+            if ((r_wen_a && get_phys_row(eff_addr_a) == row_buf_next_a) ||
+                (r_wen_b && get_phys_row(eff_addr_b) == row_buf_next_a)) begin
+                row_buf_valid_a <= 1'b0;
+            end
+        end else begin
+            burst_active_a <= 1'b0;
+            row_buf_valid_a <= 1'b0;
         end
     end
     
@@ -156,35 +367,47 @@ module m20k_bram_core #(
     always @(posedge clk) begin
         if (!rst) begin
             if (r_wen_b | r_ren_b) begin
-                phys_row_b = get_phys_row(r_addr_b);
-                col_start_b = get_phys_col(r_addr_b);
+                phys_row_b = get_phys_row(eff_addr_b);
                 
                 if (r_wen_b) begin
-                    // Write logical data to individual physical cells
+                    // Write logical data to individual physical cells, skipping disabled byte lanes
                     for (bit_idx_b = 0; bit_idx_b < LOGICAL_DATA_WIDTH; bit_idx_b = bit_idx_b + 1) begin
-                        if ((col_start_b + bit_idx_b) < PHYSICAL_COLS) begin
-                            cell_array[phys_row_b][col_start_b + bit_idx_b] <= data_in_b[bit_idx_b];
+                        if (r_be_b[bit_idx_b / BYTE_LANE_WIDTH] && get_phys_col(eff_addr_b, bit_idx_b) < PHYSICAL_COLS) begin
+                            cell_array[phys_row_b][get_phys_col(eff_addr_b, bit_idx_b)] <= r_data_in_b[bit_idx_b];
                         end
                     end
                 end
                 
                 if (r_ren_b) begin
-                    // Read logical data from individual physical cells
-                    for (bit_idx_b = 0; bit_idx_b < LOGICAL_DATA_WIDTH; bit_idx_b = bit_idx_b + 1) begin
-                        if ((col_start_b + bit_idx_b) < PHYSICAL_COLS) begin
-                            data_out_b[bit_idx_b] <= cell_array[phys_row_b][col_start_b + bit_idx_b];
-                        end else begin
-                            data_out_b[bit_idx_b] <= 1'b0;
+                    rd_data_b <= array_out_b;
+
+                    if (burst_fill_b) begin
+                        for (col_idx_b = 0; col_idx_b < PHYSICAL_COLS; col_idx_b = col_idx_b + 1) begin
+                            row_buf_b[col_idx_b] <= cell_array[phys_row_b][col_idx_b];
                         end
+                        row_buf_row_b <= phys_row_b;
+                        row_buf_valid_b <= 1'b1;
                     end
                 end
             end
+
+            burst_active_b <= burst_rd_b;
+            burst_addr_b <= eff_addr_b + 1'b1;
+
+            if ((r_wen_a && get_phys_row(eff_addr_a) == row_buf_next_b) ||
+                (r_wen_b && get_phys_row(eff_addr_b) == row_buf_next_b)) begin
+                row_buf_valid_b <= 1'b0;
+            end
+        end else begin
+            burst_active_b <= 1'b0;
+            row_buf_valid_b <= 1'b0;
         end
     end
     
     // Conservative assumption: for now, assume diff logical address on same physical row is a collision
-    reg collision = (r_wen_a | r_ren_a) && (r_wen_b | r_ren_b) && 
-                     (get_phys_row(r_addr_a) == get_phys_row(r_addr_b)) &&
+    // Burst reads served from a row buffer don't access the array, so they can't collide
+    wire collision = (r_wen_a | (r_ren_a & ~burst_hit_a)) && (r_wen_b | (r_ren_b & ~burst_hit_b)) && 
+                     (get_phys_row(eff_addr_a) == get_phys_row(eff_addr_b)) &&
                      (r_wen_a | r_wen_b);  // At least one write
     
     // Debug: print registered inputs and collision status
@@ -192,19 +415,51 @@ module m20k_bram_core #(
     always @(posedge clk) begin
         if (collision) begin
             $display("WARNING: Memory collision detected at physical row %d (addr_a=%d, addr_b=%d)", 
-                     get_phys_row(r_addr_a), r_addr_a, r_addr_b);
+                     get_phys_row(eff_addr_a), eff_addr_a, eff_addr_b);
         end
         if (r_wen_a) begin
-            $display("Physical Write Port A: Row=%d, Col_Start=%d, Width=%d, Data=%h", 
-                     get_phys_row(r_addr_a), get_phys_col(r_addr_a), LOGICAL_DATA_WIDTH, r_data_in_a);
+            $display("Physical Write Port A: Row=%d, Col_Start=%d, Col_Stride=%d, Width=%d, Data=%h, BE=%b", 
+                     get_phys_row(r_addr_a), get_phys_col(r_addr_a, 0), MUX_INTERLEAVE, LOGICAL_DATA_WIDTH, r_data_in_a, r_be_a);
         end
         if (r_wen_b) begin
-            $display("Physical Write Port B: Row=%d, Col_Start=%d, Width=%d, Data=%h", 
-                     get_phys_row(r_addr_b), get_phys_col(r_addr_b), LOGICAL_DATA_WIDTH, r_data_in_b);
+            $display("Physical Write Port B: Row=%d, Col_Start=%d, Col_Stride=%d, Width=%d, Data=%h, BE=%b", 
+                     get_phys_row(r_addr_b), get_phys_col(r_addr_b, 0), MUX_INTERLEAVE, LOGICAL_DATA_WIDTH, r_data_in_b, r_be_b);
         end
     end
     `endif
 
+    // Testbench backdoor (tb/backdoor.h): logical words are read and written directly in the cell array,
+    // with the same address mapping as the ports and without clock cycles. Burst row buffers aren't
+    // updated, so don't write the row of a burst in progress. Single cells can be read by physical
+    // row and column, to check the layout itself.
+    `ifdef TB_BACKDOOR
+    import "DPI-C" context function void tb_backdoor_register(input int kind, input int index);
+    export "DPI-C" function m20k_backdoor_write;
+    export "DPI-C" function m20k_backdoor_read;
+    export "DPI-C" function m20k_backdoor_read_cell;
+
+    function void m20k_backdoor_write(input int addr, input longint data);
+        integer b;
+        for (b = 0; b < LOGICAL_DATA_WIDTH; b = b + 1) begin
+            cell_array[get_phys_row(addr[ADDR_WIDTH-1:0])][get_phys_col(addr[ADDR_WIDTH-1:0], b)] = data[b];
+        end
+    endfunction
+
+    function longint m20k_backdoor_read(input int addr);
+        integer b;
+        m20k_backdoor_read = 0;
+        for (b = 0; b < LOGICAL_DATA_WIDTH; b = b + 1) begin
+            m20k_backdoor_read[b] = cell_array[get_phys_row(addr[ADDR_WIDTH-1:0])][get_phys_col(addr[ADDR_WIDTH-1:0], b)];
+        end
+    endfunction
+
+    function bit m20k_backdoor_read_cell(input int row, input int col);
+        m20k_backdoor_read_cell = cell_array[row[PHYSICAL_ADDR_WIDTH-1:0]][col[PHYSICAL_COL_WIDTH-1:0]];
+    endfunction
+
+    initial tb_backdoor_register(1, INSTANCE_ID);
+    `endif
+
     // Assertions for verification - dont use registered inputs, want instant feedback on inputs
     `ifdef FORMAL
     always @(posedge clk) begin
@@ -222,10 +477,10 @@ module m20k_bram_core #(
             
         // Check that column access is within bounds
         if (wen_a || ren_a)
-            assert((get_phys_col(addr_a) + LOGICAL_DATA_WIDTH) <= PHYSICAL_COLS) 
+            assert(get_phys_col(addr_a, LOGICAL_DATA_WIDTH-1) < PHYSICAL_COLS) 
                 else $error("Physical column A access out of bounds");
         if (wen_b || ren_b)
-            assert((get_phys_col(addr_b) + LOGICAL_DATA_WIDTH) <= PHYSICAL_COLS) 
+            assert(get_phys_col(addr_b, LOGICAL_DATA_WIDTH-1) < PHYSICAL_COLS) 
                 else $error("Physical column B access out of bounds");
     end
     `endif
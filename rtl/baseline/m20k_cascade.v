@@ -0,0 +1,194 @@
+// Cascade of M20K BRAM models
+// Stitches NUM_WIDE x NUM_DEEP m20k_bram_core instances into one wider and/or deeper logical memory
+// Width: blocks side by side share the address, each one holds a slice of the data word
+// Depth: the upper address bits select a row of blocks, and the read data is muxed back
+
+module m20k_cascade #(
+    // Configuration of each M20K block
+    parameter LOGICAL_DATA_WIDTH = 8,
+    parameter LOGICAL_DEPTH = 2048,
+    parameter BYTE_LANE_WIDTH = 8,
+    parameter REG_INPUTS = 1,             // Input/output registers of each block, see m20k_bram_core
+    parameter REG_OUTPUTS = 1,
+
+    // Cascade configuration
+    parameter NUM_WIDE = 2,               // Blocks concatenated to widen the data word
+    parameter NUM_DEEP = 2,               // Blocks stacked to deepen the address space
+    parameter OUT_MUX_REG = 1,            // Register the depth mux output (adds a cycle, like the cascade routing in fabric)
+
+    parameter CASCADE_WIDTH = NUM_WIDE * LOGICAL_DATA_WIDTH,
+    parameter CASCADE_DEPTH = NUM_DEEP * LOGICAL_DEPTH,
+    parameter LANES_PER_BLOCK = (LOGICAL_DATA_WIDTH + BYTE_LANE_WIDTH - 1) / BYTE_LANE_WIDTH
+) (
+    input wire clk,
+    input wire rst,
+
+    // Port A
+    input wire [$clog2(CASCADE_DEPTH)-1:0] addr_a,
+    input wire [CASCADE_WIDTH-1:0] data_in_a,
+    input wire [NUM_WIDE*LANES_PER_BLOCK-1:0] be_a,
+    input wire wen_a,
+    input wire ren_a,
+    output reg [CASCADE_WIDTH-1:0] data_out_a,
+
+    // Port B
+    input wire [$clog2(CASCADE_DEPTH)-1:0] addr_b,
+    input wire [CASCADE_WIDTH-1:0] data_in_b,
+    input wire [NUM_WIDE*LANES_PER_BLOCK-1:0] be_b,
+    input wire wen_b,
+    input wire ren_b,
+    output reg [CASCADE_WIDTH-1:0] data_out_b,
+
+    // Activity counters summed over all blocks
+    output reg [31:0] wl_activations,
+    output reg [31:0] bitlines_sensed,
+    output reg [31:0] cells_written
+);
+
+    localparam BLOCK_ADDR_WIDTH = $clog2(LOGICAL_DEPTH);
+    localparam SEL_WIDTH = (NUM_DEEP > 1) ? $clog2(NUM_DEEP) : 1;
+    localparam NUM_BLOCKS = NUM_WIDE * NUM_DEEP;
+    // m20k_bram_core read latency
+    localparam BLOCK_READ_LATENCY = REG_INPUTS + REG_OUTPUTS;
+    localparam READ_LATENCY = BLOCK_READ_LATENCY + OUT_MUX_REG;
+
+    // Address decode: addr / LOGICAL_DEPTH picks the row of blocks, addr % LOGICAL_DEPTH addresses inside the
+    // block (the upper and lower address bits when LOGICAL_DEPTH is a power of two). Addresses past
+    // CASCADE_DEPTH, which exist when it isn't a power of two, don't enable any block.
+    wire in_range_a = addr_a < CASCADE_DEPTH;
+    wire in_range_b = addr_b < CASCADE_DEPTH;
+    wire [SEL_WIDTH-1:0] sel_a = addr_a / LOGICAL_DEPTH;
+    wire [SEL_WIDTH-1:0] sel_b = addr_b / LOGICAL_DEPTH;
+    wire [BLOCK_ADDR_WIDTH-1:0] block_addr_a = addr_a % LOGICAL_DEPTH;
+    wire [BLOCK_ADDR_WIDTH-1:0] block_addr_b = addr_b % LOGICAL_DEPTH;
+
+    // Outputs of every block, row of blocks d occupies [d*CASCADE_WIDTH +: CASCADE_WIDTH]
+    wire [NUM_DEEP*CASCADE_WIDTH-1:0] deep_out_a, deep_out_b;
+    wire [32*NUM_BLOCKS-1:0] blk_wl_activations, blk_bitlines_sensed, blk_cells_written;
+
+    genvar deep_idx, wide_idx;
+    generate
+        for (deep_idx = 0; deep_idx < NUM_DEEP; deep_idx = deep_idx + 1) begin : deep_gen
+            for (wide_idx = 0; wide_idx < NUM_WIDE; wide_idx = wide_idx + 1) begin : wide_gen
+                // Only the selected row of blocks sees the enables
+                m20k_bram_core #(
+                    .LOGICAL_DATA_WIDTH(LOGICAL_DATA_WIDTH),
+                    .LOGICAL_DEPTH(LOGICAL_DEPTH),
+                    .BYTE_LANE_WIDTH(BYTE_LANE_WIDTH),
+                    .REG_INPUTS(REG_INPUTS),
+                    .REG_OUTPUTS(REG_OUTPUTS),
+                    .INSTANCE_ID(deep_idx * NUM_WIDE + wide_idx)   // Backdoor index: row of blocks, then slice
+                ) m20k_inst (
+                    .clk(clk),
+                    .rst(rst),
+
+                    .addr_a(block_addr_a),
+                    .data_in_a(data_in_a[wide_idx*LOGICAL_DATA_WIDTH +: LOGICAL_DATA_WIDTH]),
+                    .be_a(be_a[wide_idx*LANES_PER_BLOCK +: LANES_PER_BLOCK]),
+                    .wen_a(wen_a && in_range_a && (sel_a == deep_idx)),
+                    .ren_a(ren_a && in_range_a && (sel_a == deep_idx)),
+                    .burst_a(1'b0), // Bursts would wrap inside a block, so the cascade doesn't expose them
+                    .data_out_a(deep_out_a[(deep_idx*CASCADE_WIDTH + wide_idx*LOGICAL_DATA_WIDTH) +: LOGICAL_DATA_WIDTH]),
+
+                    .addr_b(block_addr_b),
+                    .data_in_b(data_in_b[wide_idx*LOGICAL_DATA_WIDTH +: LOGICAL_DATA_WIDTH]),
+                    .be_b(be_b[wide_idx*LANES_PER_BLOCK +: LANES_PER_BLOCK]),
+                    .wen_b(wen_b && in_range_b && (sel_b == deep_idx)),
+                    .ren_b(ren_b && in_range_b && (sel_b == deep_idx)),
+                    .burst_b(1'b0),
+                    .data_out_b(deep_out_b[(deep_idx*CASCADE_WIDTH + wide_idx*LOGICAL_DATA_WIDTH) +: LOGICAL_DATA_WIDTH]),
+
+                    .wl_activations(blk_wl_activations[(deep_idx*NUM_WIDE + wide_idx)*32 +: 32]),
+                    .bitlines_sensed(blk_bitlines_sensed[(deep_idx*NUM_WIDE + wide_idx)*32 +: 32]),
+                    .cells_written(blk_cells_written[(deep_idx*NUM_WIDE + wide_idx)*32 +: 32])
+                );
+            end
+        end
+    endgenerate
+
+    // Select of the row of blocks whose data is on the mux. Blocks hold their output between reads, so the
+    // select of each read is delayed to line up with its data and then held; address changes without a
+    // read don't move the mux, and neither do reads past CASCADE_DEPTH.
+    wire [SEL_WIDTH-1:0] cur_sel_a, cur_sel_b;
+    reg [SEL_WIDTH-1:0] held_sel_a, held_sel_b;
+
+    generate
+        if (BLOCK_READ_LATENCY == 0) begin : sel_comb_gen
+            // Blocks without registers show the array during the read itself
+            assign cur_sel_a = (ren_a && in_range_a) ? sel_a : held_sel_a;
+            assign cur_sel_b = (ren_b && in_range_b) ? sel_b : held_sel_b;
+        end else begin : sel_pipe_gen
+            reg [SEL_WIDTH-1:0] r_sel_a [0:BLOCK_READ_LATENCY-1];
+            reg [SEL_WIDTH-1:0] r_sel_b [0:BLOCK_READ_LATENCY-1];
+            reg r_rd_a [0:BLOCK_READ_LATENCY-1];    // Stage holds a read
+            reg r_rd_b [0:BLOCK_READ_LATENCY-1];
+            integer stage;
+            always @(posedge clk) begin
+                r_sel_a[0] <= sel_a;
+                r_sel_b[0] <= sel_b;
+                r_rd_a[0] <= ren_a & in_range_a & ~rst;
+                r_rd_b[0] <= ren_b & in_range_b & ~rst;
+                for (stage = 1; stage < BLOCK_READ_LATENCY; stage = stage + 1) begin
+                    r_sel_a[stage] <= r_sel_a[stage-1];
+                    r_sel_b[stage] <= r_sel_b[stage-1];
+                    r_rd_a[stage] <= r_rd_a[stage-1] & ~rst;
+                    r_rd_b[stage] <= r_rd_b[stage-1] & ~rst;
+                end
+            end
+            assign cur_sel_a = r_rd_a[BLOCK_READ_LATENCY-1] ? r_sel_a[BLOCK_READ_LATENCY-1] : held_sel_a;
+            assign cur_sel_b = r_rd_b[BLOCK_READ_LATENCY-1] ? r_sel_b[BLOCK_READ_LATENCY-1] : held_sel_b;
+        end
+    endgenerate
+
+    initial begin
+        held_sel_a = {SEL_WIDTH{1'b0}};
+        held_sel_b = {SEL_WIDTH{1'b0}};
+    end
+
+    always @(posedge clk) begin
+        held_sel_a <= cur_sel_a;
+        held_sel_b <= cur_sel_b;
+    end
+
+    // Output mux across the rows of blocks
+    wire [CASCADE_WIDTH-1:0] mux_out_a = deep_out_a[cur_sel_a*CASCADE_WIDTH +: CASCADE_WIDTH];
+    wire [CASCADE_WIDTH-1:0] mux_out_b = deep_out_b[cur_sel_b*CASCADE_WIDTH +: CASCADE_WIDTH];
+
+    generate
+        if (OUT_MUX_REG) begin : out_reg_gen
+            always @(posedge clk) begin
+                data_out_a <= mux_out_a;
+                data_out_b <= mux_out_b;
+            end
+        end else begin : out_comb_gen
+            always @(*) begin
+                data_out_a = mux_out_a;
+                data_out_b = mux_out_b;
+            end
+        end
+    endgenerate
+
+    // Sum the activity of all blocks
+    integer blk;
+    always @(*) begin
+        wl_activations = 32'd0;
+        bitlines_sensed = 32'd0;
+        cells_written = 32'd0;
+        for (blk = 0; blk < NUM_BLOCKS; blk = blk + 1) begin
+            wl_activations = wl_activations + blk_wl_activations[blk*32 +: 32];
+            bitlines_sensed = bitlines_sensed + blk_bitlines_sensed[blk*32 +: 32];
+            cells_written = cells_written + blk_cells_written[blk*32 +: 32];
+        end
+    end
+
+    // Debug: show which block serves each access
+    `ifdef DEBUG_M20K
+    always @(posedge clk) begin
+        if (wen_a | ren_a)
+            $display("Cascade Port A: addr=%d -> block row %d, block addr %d", addr_a, sel_a, block_addr_a);
+        if (wen_b | ren_b)
+            $display("Cascade Port B: addr=%d -> block row %d, block addr %d", addr_b, sel_b, block_addr_b);
+    end
+    `endif
+
+endmodule
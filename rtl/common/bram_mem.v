@@ -1,12 +1,22 @@
 module bram_mem # (
     parameter DATAW = 8,
     parameter DEPTH = 4,
-    parameter ADDRW = $clog2(DEPTH)
+    parameter ADDRW = $clog2(DEPTH),
+    // Optional pipeline registers, like the M20K's input and output registers.
+    // Read latency is REG_INPUTS + REG_OUTPUT cycles, write latency REG_INPUTS + 1.
+    // With both off the read is asynchronous, which only maps to MLABs/LUT RAM.
+    parameter REG_INPUTS = 1,
+    parameter REG_OUTPUT = 1,
+    // Simulation only: contents loaded with $readmemh at startup (word i on line i), "" keeps them zero
+    parameter INIT_FILE = "",
+    // Simulation only: index the instance registers under for the testbench backdoor (TB_BACKDOOR)
+    parameter INSTANCE_ID = 0
 )(
     input  clk,
     input  [DATAW-1:0] wdata,
     input  [ADDRW-1:0] waddr,
     input  wen,
+    input  ren,                 // Read enable, rdata holds while low (only with REG_OUTPUT)
     input  [ADDRW-1:0] raddr,
     output reg [DATAW-1:0] rdata
 );
@@ -15,26 +25,66 @@ module bram_mem # (
 
 reg [DATAW-1:0] r_wdata;
 reg [ADDRW-1:0] r_waddr, r_raddr;
-reg r_wen;
+reg r_wen, r_ren;
+
+// Inputs as seen by the array
+wire [DATAW-1:0] a_wdata = REG_INPUTS ? r_wdata : wdata;
+wire [ADDRW-1:0] a_waddr = REG_INPUTS ? r_waddr : waddr;
+wire [ADDRW-1:0] a_raddr = REG_INPUTS ? r_raddr : raddr;
+wire a_wen = REG_INPUTS ? r_wen : wen;
+wire a_ren = REG_INPUTS ? r_ren : ren;
 
 integer i;
 initial begin
     for (i = 0; i < DEPTH; i = i + 1) begin
         mem[i] = 0;
     end
+    if (INIT_FILE != "") $readmemh(INIT_FILE, mem);
 end
 
+`ifdef TB_BACKDOOR
+// Testbench backdoor (tb/backdoor.h): the testbench reads and writes mem directly, without clock cycles.
+// Each instance registers its scope under INSTANCE_ID so the testbench can pick one.
+import "DPI-C" context function void tb_backdoor_register(input int kind, input int index);
+export "DPI-C" function bram_mem_backdoor_write;
+export "DPI-C" function bram_mem_backdoor_read;
+
+function void bram_mem_backdoor_write(input int addr, input longint data);
+    mem[addr[ADDRW-1:0]] = data[DATAW-1:0];
+endfunction
+
+function longint bram_mem_backdoor_read(input int addr);
+    bram_mem_backdoor_read = 0;
+    bram_mem_backdoor_read[DATAW-1:0] = mem[addr[ADDRW-1:0]];
+endfunction
+
+initial tb_backdoor_register(0, INSTANCE_ID);
+`endif
+
 always @ (posedge clk) begin
     // Register Inputs
     r_wdata <= wdata;
     r_waddr <= waddr;
     r_wen <= wen;
     r_raddr <= raddr;
-    
+    r_ren <= ren;
+
     // Write logic
-    if (r_wen) mem[r_waddr] <= r_wdata;
-    // Read logic
-    rdata <= mem[r_raddr];
+    if (a_wen) mem[a_waddr] <= a_wdata;
 end
 
+// Read logic
+generate
+    if (REG_OUTPUT) begin : out_reg_gen
+        initial rdata = 0;
+        always @ (posedge clk) begin
+            if (a_ren) rdata <= mem[a_raddr];
+        end
+    end else begin : out_comb_gen
+        always @ (*) begin
+            rdata = mem[a_raddr];
+        end
+    end
+endgenerate
+
 endmodule
\ No newline at end of file
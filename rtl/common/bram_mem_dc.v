@@ -0,0 +1,57 @@
+// Simple dual-port BRAM with independent write and read clocks, like an M20K in simple dual-port
+// mode with separate port clocks. Same registers as bram_mem: inputs are registered on their own
+// clock, the read data on the read clock (read latency 2 rclk cycles, write latency 2 wclk cycles).
+// Reading an address in the same window as it is written returns undefined data on real hardware,
+// so the user must keep the two ports on different addresses (see circulant_barrel_shifter_dc).
+module bram_mem_dc # (
+    parameter DATAW = 8,
+    parameter DEPTH = 4,
+    parameter ADDRW = $clog2(DEPTH)
+)(
+    // Write port
+    input  wclk,
+    input  [DATAW-1:0] wdata,
+    input  [ADDRW-1:0] waddr,
+    input  wen,
+
+    // Read port
+    input  rclk,
+    input  ren,
+    input  [ADDRW-1:0] raddr,
+    output reg [DATAW-1:0] rdata
+);
+
+(* ramstyle = "M20K" *) reg [DATAW-1:0] mem [0:DEPTH-1];
+
+reg [DATAW-1:0] r_wdata;
+reg [ADDRW-1:0] r_waddr, r_raddr;
+reg r_wen, r_ren;
+
+integer i;
+initial begin
+    for (i = 0; i < DEPTH; i = i + 1) begin
+        mem[i] = 0;
+    end
+    rdata = 0;
+end
+
+always @ (posedge wclk) begin
+    // Register Inputs
+    r_wdata <= wdata;
+    r_waddr <= waddr;
+    r_wen <= wen;
+
+    // Write logic
+    if (r_wen) mem[r_waddr] <= r_wdata;
+end
+
+always @ (posedge rclk) begin
+    // Register Inputs
+    r_raddr <= raddr;
+    r_ren <= ren;
+
+    // Read logic
+    if (r_ren) rdata <= mem[r_raddr];
+end
+
+endmodule
\ No newline at end of file
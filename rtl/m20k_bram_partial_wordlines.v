@@ -1,12 +1,22 @@
-// M20K BRAM functional model
-// Supports dual port true dual-port mode
-// Supports set of logical widths
+// M20K BRAM functional model with partial wordlines
+// Same array and logical ports as m20k_bram_core, plus a bit-transpose port that stores a
+// BIT_TILE_ROWS x BIT_TILE_COLS bit matrix circulant-skewed in the array and reads it back transposed.
 // Physical organization: 128 rows × 160 columns (individual bit cells)
+//
+// Bit-transpose layout: bit c of tile row r is stored at physical row r, column (r + c) mod BIT_TILE_COLS.
+// - Writing tile row r drives one wordline (physical row r); the write crossbar rotates the row by r.
+// - Reading tile column c needs bit (r, c) from physical row r, column (r + c) mod BIT_TILE_COLS for every r.
+//   These are all different columns, so with a separate wordline segment per column (partial wordlines)
+//   each column activates its own row and the whole column comes out in one access. The read crossbar
+//   rotates it back by c. This assumes every column has its own sense amp, as in CoMeFa's compute mode,
+//   rather than sharing one between COL_MUX_FACTOR columns.
+// The transpose happens in place: the stored tile is read either way without moving data.
+// Ports A and B must be idle while the bit-transpose port accesses the array.
 
 // What happens when:
 // write to the same address over both ports?
 
-module m20k_bram_core #(
+module m20k_bram_partial_wordlines #(
     // Logical configuration parameters
     parameter LOGICAL_DATA_WIDTH = 8,     // Logical data width (40, 8, 4)
     parameter LOGICAL_DEPTH = 2048,       // Logical depth (512, 2k, 4K)
@@ -14,7 +24,19 @@ module m20k_bram_core #(
     // Physical parameters from https://ieeexplore.ieee.org/document/9786179 (CoMeFa)
     parameter PHYSICAL_ROWS = 128,
     parameter PHYSICAL_COLS = 160,
-    parameter COL_MUX_FACTOR = 4          // Since widest supported width is 40 bits
+    parameter COL_MUX_FACTOR = 4,         // Since widest supported width is 40 bits
+    parameter BYTE_LANE_WIDTH = 8,        // Bits covered by each byte enable (real M20Ks use 10 in x20/x40 modes)
+
+    // Optional registers around the array. Read latency is REG_INPUTS + REG_OUTPUTS cycles.
+    // A real M20K always registers its inputs and makes the output register optional (latency 2 or 1);
+    // REG_INPUTS = 0 has no M20K equivalent and is only meant for latency experiments.
+    parameter REG_INPUTS = 1,
+    parameter REG_OUTPUTS = 1,
+
+    // Bit-transpose tile, stored in physical rows [0, BIT_TILE_ROWS) and columns [0, BIT_TILE_COLS).
+    // BIT_TILE_ROWS <= BIT_TILE_COLS so every column of a transposed read is on a different bitline.
+    parameter BIT_TILE_ROWS = 40,
+    parameter BIT_TILE_COLS = 40
 ) (
     input wire clk,
     input wire rst,
@@ -22,16 +44,35 @@ module m20k_bram_core #(
     // Port A
     input wire [$clog2(LOGICAL_DEPTH)-1:0] addr_a,
     input wire [LOGICAL_DATA_WIDTH-1:0] data_in_a,
+    input wire [(LOGICAL_DATA_WIDTH+BYTE_LANE_WIDTH-1)/BYTE_LANE_WIDTH-1:0] be_a, // Per-lane write enables
     input wire wen_a,
     input wire ren_a,
+    input wire burst_a,                 // Burst read: auto-increments from addr_a while held with ren_a
     output reg [LOGICAL_DATA_WIDTH-1:0] data_out_a,
     
     // Port B
     input wire [$clog2(LOGICAL_DEPTH)-1:0] addr_b,
     input wire [LOGICAL_DATA_WIDTH-1:0] data_in_b,
+    input wire [(LOGICAL_DATA_WIDTH+BYTE_LANE_WIDTH-1)/BYTE_LANE_WIDTH-1:0] be_b, // Per-lane write enables
     input wire wen_b,
     input wire ren_b,
-    output reg [LOGICAL_DATA_WIDTH-1:0] data_out_b
+    input wire burst_b,                 // Burst read: auto-increments from addr_b while held with ren_b
+    output reg [LOGICAL_DATA_WIDTH-1:0] data_out_b,
+
+    // Bit-transpose port. Write tile rows, read tile columns (rows of the transpose), same latency
+    // as the logical ports. Data is a full physical row/column wide, only the low BIT_TILE_COLS
+    // (write) or BIT_TILE_ROWS (read) bits are used.
+    input wire bit_wen,
+    input wire [$clog2(PHYSICAL_ROWS)-1:0] bit_waddr,          // Tile row
+    input wire [PHYSICAL_COLS-1:0] bit_wdata,
+    input wire bit_ren,
+    input wire [$clog2(PHYSICAL_COLS)-1:0] bit_raddr,          // Tile column
+    output reg [PHYSICAL_ROWS-1:0] bit_rdata,
+
+    // Activity counters for the energy model (cumulative since reset)
+    output reg [31:0] wl_activations,     // Physical wordlines driven (one per port access)
+    output reg [31:0] bitlines_sensed,    // Columns read out through the sense amps
+    output reg [31:0] cells_written       // Individual bit cells written
 );
 
     // Local parameters
@@ -39,27 +80,76 @@ module m20k_bram_core #(
     localparam PHYSICAL_ADDR_WIDTH = $clog2(PHYSICAL_ROWS);
     localparam PHYSICAL_COL_WIDTH = $clog2(PHYSICAL_COLS);
     localparam LOG_TO_PHYS_BITS = PHYSICAL_COLS / LOGICAL_DATA_WIDTH;
+    // Column multiplexing: each sense amp serves COL_MUX_FACTOR adjacent columns, so the bits of a
+    // logical word are interleaved COL_MUX_FACTOR columns apart and neighbouring words share sense amps.
+    // Widths whose words-per-row isn't a multiple of the mux factor fall back to contiguous packing.
+    localparam MUX_INTERLEAVE = (LOG_TO_PHYS_BITS % COL_MUX_FACTOR == 0) ? COL_MUX_FACTOR : 1;
+    localparam NUM_LANES = (LOGICAL_DATA_WIDTH + BYTE_LANE_WIDTH - 1) / BYTE_LANE_WIDTH;
 
     // 2D array of individual SRAM cells 
     reg cell_array [0:PHYSICAL_ROWS-1][0:PHYSICAL_COLS-1];
     
     // Variables for address decoding 
     reg [PHYSICAL_ADDR_WIDTH-1:0] phys_row_a, phys_row_b;
-    reg [PHYSICAL_COL_WIDTH-1:0] col_start_a, col_start_b;
     integer bit_idx_a, bit_idx_b; // Loop variables
 
-    // Registerd inputs
+    // Registerd inputs, or the ports themselves when REG_INPUTS = 0. These are what the array sees.
     // Port A
     reg [$clog2(LOGICAL_DEPTH)-1:0] r_addr_a;
     reg [LOGICAL_DATA_WIDTH-1:0] r_data_in_a;
+    reg [NUM_LANES-1:0] r_be_a;
     reg r_wen_a;
     reg r_ren_a;
+    reg r_burst_a;
     // Port B
     reg [$clog2(LOGICAL_DEPTH)-1:0] r_addr_b;
     reg [LOGICAL_DATA_WIDTH-1:0] r_data_in_b;
+    reg [NUM_LANES-1:0] r_be_b;
     reg r_wen_b;
     reg r_ren_b;
+    reg r_burst_b;
+    // Bit-transpose port
+    reg [PHYSICAL_ADDR_WIDTH-1:0] r_bit_waddr;
+    reg [PHYSICAL_COLS-1:0] r_bit_wdata;
+    reg r_bit_wen;
+    reg [PHYSICAL_COL_WIDTH-1:0] r_bit_raddr;
+    reg r_bit_ren;
+
+    // Burst read state per port. A burst latches a whole physical row into the port's row buffer
+    // (every column sensed at once) and serves the following sequential logical words from it,
+    // leaving the array free instead of re-activating the same wordline for each word.
+    reg row_buf_a [0:PHYSICAL_COLS-1];
+    reg row_buf_b [0:PHYSICAL_COLS-1];
+    reg [PHYSICAL_ADDR_WIDTH-1:0] row_buf_row_a, row_buf_row_b;
+    reg row_buf_valid_a, row_buf_valid_b;
+    reg burst_active_a, burst_active_b;
+    reg [ADDR_WIDTH-1:0] burst_addr_a, burst_addr_b; // Next address of an ongoing burst
+    integer col_idx_a, col_idx_b;
+
+    // Data read from the array, latched on the clock edge of each read. This is the output register,
+    // and without it the sense amps still hold the last word between reads.
+    reg [LOGICAL_DATA_WIDTH-1:0] rd_data_a, rd_data_b;
+    // Data read from the array during the current cycle, before the clock edge
+    reg [LOGICAL_DATA_WIDTH-1:0] array_out_a, array_out_b;
+    // Same for the bit-transpose port
+    reg [PHYSICAL_ROWS-1:0] bit_rd_data;
+    reg [PHYSICAL_ROWS-1:0] bit_array_out;
     
+    // Burst address and row buffer decode
+    // A burst read continues from the auto-incremented address; everything else uses the input address
+    wire burst_rd_a = r_ren_a & r_burst_a & ~r_wen_a;
+    wire [ADDR_WIDTH-1:0] eff_addr_a = (burst_rd_a & burst_active_a) ? burst_addr_a : r_addr_a;
+    wire burst_hit_a = burst_rd_a & row_buf_valid_a & (row_buf_row_a == get_phys_row(eff_addr_a));
+    wire burst_fill_a = burst_rd_a & ~burst_hit_a;
+    // Row held by the buffer after this cycle, used to keep it coherent with writes
+    wire [PHYSICAL_ADDR_WIDTH-1:0] row_buf_next_a = burst_fill_a ? get_phys_row(eff_addr_a) : row_buf_row_a;
+
+    wire burst_rd_b = r_ren_b & r_burst_b & ~r_wen_b;
+    wire [ADDR_WIDTH-1:0] eff_addr_b = (burst_rd_b & burst_active_b) ? burst_addr_b : r_addr_b;
+    wire burst_hit_b = burst_rd_b & row_buf_valid_b & (row_buf_row_b == get_phys_row(eff_addr_b));
+    wire burst_fill_b = burst_rd_b & ~burst_hit_b;
+    wire [PHYSICAL_ADDR_WIDTH-1:0] row_buf_next_b = burst_fill_b ? get_phys_row(eff_addr_b) : row_buf_row_b;
+
     // Initialize physical memory
     initial begin
         integer row, col;
@@ -68,38 +158,136 @@ module m20k_bram_core #(
                 cell_array[row][col] = 1'b0;
             end
         end
-        data_out_a = {LOGICAL_DATA_WIDTH{1'b0}};
-        data_out_b = {LOGICAL_DATA_WIDTH{1'b0}};
+        rd_data_a = {LOGICAL_DATA_WIDTH{1'b0}};
+        rd_data_b = {LOGICAL_DATA_WIDTH{1'b0}};
+        bit_rd_data = {PHYSICAL_ROWS{1'b0}};
+        wl_activations = 32'd0;
+        bitlines_sensed = 32'd0;
+        cells_written = 32'd0;
+        row_buf_valid_a = 1'b0;
+        row_buf_valid_b = 1'b0;
+        burst_active_a = 1'b0;
+        burst_active_b = 1'b0;
     end
     
+    // Input registers
+    generate
+        if (REG_INPUTS) begin : in_reg_gen
+            always @(posedge clk or posedge rst) begin
+                if (rst) begin
+                    r_addr_a <= {ADDR_WIDTH{1'b0}};
+                    r_data_in_a <= {LOGICAL_DATA_WIDTH{1'b0}};
+                    r_be_a <= {NUM_LANES{1'b0}};
+                    r_wen_a <= 1'b0;
+                    r_ren_a <= 1'b0;
+                    r_burst_a <= 1'b0;
+
+                    r_addr_b <= {ADDR_WIDTH{1'b0}};
+                    r_data_in_b <= {LOGICAL_DATA_WIDTH{1'b0}};
+                    r_be_b <= {NUM_LANES{1'b0}};
+                    r_wen_b <= 1'b0;
+                    r_ren_b <= 1'b0;
+                    r_burst_b <= 1'b0;
+
+                    r_bit_waddr <= {PHYSICAL_ADDR_WIDTH{1'b0}};
+                    r_bit_wdata <= {PHYSICAL_COLS{1'b0}};
+                    r_bit_wen <= 1'b0;
+                    r_bit_raddr <= {PHYSICAL_COL_WIDTH{1'b0}};
+                    r_bit_ren <= 1'b0;
+                end
+                else begin
+                    r_addr_a <= addr_a;
+                    r_data_in_a <= data_in_a;
+                    r_be_a <= be_a;
+                    r_wen_a <= wen_a;
+                    r_ren_a <= ren_a;
+                    r_burst_a <= burst_a;
+
+                    r_addr_b <= addr_b;
+                    r_data_in_b <= data_in_b;
+                    r_be_b <= be_b;
+                    r_wen_b <= wen_b;
+                    r_ren_b <= ren_b;
+                    r_burst_b <= burst_b;
+
+                    r_bit_waddr <= bit_waddr;
+                    r_bit_wdata <= bit_wdata;
+                    r_bit_wen <= bit_wen;
+                    r_bit_raddr <= bit_raddr;
+                    r_bit_ren <= bit_ren;
+                end
+            end
+        end else begin : in_comb_gen
+            // Ports drive the array directly, accesses happen on the edge that samples them
+            always @(*) begin
+                r_addr_a = addr_a;
+                r_data_in_a = data_in_a;
+                r_be_a = be_a;
+                r_wen_a = wen_a & ~rst;
+                r_ren_a = ren_a & ~rst;
+                r_burst_a = burst_a;
+
+                r_addr_b = addr_b;
+                r_data_in_b = data_in_b;
+                r_be_b = be_b;
+                r_wen_b = wen_b & ~rst;
+                r_ren_b = ren_b & ~rst;
+                r_burst_b = burst_b;
+
+                r_bit_waddr = bit_waddr;
+                r_bit_wdata = bit_wdata;
+                r_bit_wen = bit_wen & ~rst;
+                r_bit_raddr = bit_raddr;
+                r_bit_ren = bit_ren & ~rst;
+            end
+        end
+    endgenerate
+
+    // Output registers. Without them data_out follows the array during a read, then holds.
+    generate
+        if (REG_OUTPUTS) begin : out_reg_gen
+            always @(*) begin
+                data_out_a = rd_data_a;
+                data_out_b = rd_data_b;
+                bit_rdata = bit_rd_data;
+            end
+        end else begin : out_comb_gen
+            always @(*) begin
+                data_out_a = r_ren_a ? array_out_a : rd_data_a;
+                data_out_b = r_ren_b ? array_out_b : rd_data_b;
+                bit_rdata = r_bit_ren ? bit_array_out : bit_rd_data;
+            end
+        end
+    endgenerate
+
     // Reset logic
     always @(posedge clk or posedge rst) begin
         if (rst) begin
-            // Reset outputs and registered inputs
-            data_out_a <= {LOGICAL_DATA_WIDTH{1'b0}};
-            data_out_b <= {LOGICAL_DATA_WIDTH{1'b0}};
+            // Reset outputs and counters
+            rd_data_a <= {LOGICAL_DATA_WIDTH{1'b0}};
+            rd_data_b <= {LOGICAL_DATA_WIDTH{1'b0}};
+            bit_rd_data <= {PHYSICAL_ROWS{1'b0}};
 
-            r_addr_a <= {ADDR_WIDTH{1'b0}};
-            r_data_in_a <= {LOGICAL_DATA_WIDTH{1'b0}};
-            r_wen_a <= 1'b0;
-            r_ren_a <= 1'b0;
-
-            r_addr_b <= {ADDR_WIDTH{1'b0}};
-            r_data_in_b <= {LOGICAL_DATA_WIDTH{1'b0}};
-            r_wen_b <= 1'b0;
-            r_ren_b <= 1'b0;
+            wl_activations <= 32'd0;
+            bitlines_sensed <= 32'd0;
+            cells_written <= 32'd0;
         end
         else begin
-            // Register inputs
-            r_addr_a <= addr_a;
-            r_data_in_a <= data_in_a;
-            r_wen_a <= wen_a;
-            r_ren_a <= ren_a;
-
-            r_addr_b <= addr_b;
-            r_data_in_b <= data_in_b;
-            r_wen_b <= wen_b;
-            r_ren_b <= ren_b;
+            // Count the array activity of the accesses performed this cycle.
+            // A read and a write on the same port share one wordline activation,
+            // and burst reads served from the row buffer don't touch the array.
+            // A transposed bit read drives one wordline segment per tile row.
+            wl_activations <= wl_activations + ((r_wen_a | r_ren_a) & ~burst_hit_a)
+                                             + ((r_wen_b | r_ren_b) & ~burst_hit_b)
+                                             + r_bit_wen + (r_bit_ren ? BIT_TILE_ROWS : 0);
+            bitlines_sensed <= bitlines_sensed + (burst_fill_a ? PHYSICAL_COLS : 
+                                                  (r_ren_a & ~burst_hit_a) ? LOGICAL_DATA_WIDTH : 0)
+                                               + (burst_fill_b ? PHYSICAL_COLS : 
+                                                  (r_ren_b & ~burst_hit_b) ? LOGICAL_DATA_WIDTH : 0)
+                                               + (r_bit_ren ? BIT_TILE_ROWS : 0);
+            cells_written <= cells_written + (r_wen_a ? lane_bits(r_be_a) : 0)
+                                           + (r_wen_b ? lane_bits(r_be_b) : 0)
+                                           + (r_bit_wen ? BIT_TILE_COLS : 0);
         end
     end
     
@@ -112,43 +300,142 @@ module m20k_bram_core #(
         end
     endfunction
     
-    // Find the starting physical column for a logical word
+    // Find the physical column holding one bit of a logical word
     function [PHYSICAL_COL_WIDTH-1:0] get_phys_col;
         input [ADDR_WIDTH-1:0] logical_addr;
+        input [PHYSICAL_COL_WIDTH-1:0] bit_idx;
+        reg [PHYSICAL_COL_WIDTH-1:0] word_slot;
         begin
-            // Column start = (logical_addr % words_per_row) * logical_data_width
-            get_phys_col = (logical_addr % LOG_TO_PHYS_BITS) * LOGICAL_DATA_WIDTH;
+            // Words in a row are grouped into sets of MUX_INTERLEAVE that share the same sense amps.
+            // Bit b of a word sits under sense amp b of its set, at mux position word_slot % MUX_INTERLEAVE
+            word_slot = logical_addr % LOG_TO_PHYS_BITS;
+            get_phys_col = (word_slot / MUX_INTERLEAVE) * (LOGICAL_DATA_WIDTH * MUX_INTERLEAVE) +
+                           bit_idx * MUX_INTERLEAVE + (word_slot % MUX_INTERLEAVE);
         end
     endfunction
     
+    // Number of data bits covered by the enabled byte lanes (the last lane may be partial)
+    function [31:0] lane_bits;
+        input [NUM_LANES-1:0] be;
+        integer lane;
+        begin
+            lane_bits = 0;
+            for (lane = 0; lane < NUM_LANES; lane = lane + 1) begin
+                if (be[lane]) begin
+                    lane_bits = lane_bits + (((lane + 1) * BYTE_LANE_WIDTH > LOGICAL_DATA_WIDTH) ?
+                                             (LOGICAL_DATA_WIDTH - lane * BYTE_LANE_WIDTH) : BYTE_LANE_WIDTH);
+                end
+            end
+        end
+    endfunction
+
+    // Physical column of bit c of tile row r in the bit-transpose layout
+    function [PHYSICAL_COL_WIDTH-1:0] bit_tile_col;
+        input [PHYSICAL_ADDR_WIDTH-1:0] tile_row;
+        input [PHYSICAL_COL_WIDTH-1:0] tile_col;
+        reg [PHYSICAL_COL_WIDTH:0] sum; // Wide enough for the carry
+        begin
+            sum = tile_row + tile_col;
+            bit_tile_col = sum % BIT_TILE_COLS;
+        end
+    endfunction
+
+    // Array read for each port
+    integer rd_bit_a, rd_bit_b;
+    always @(*) begin
+        for (rd_bit_a = 0; rd_bit_a < LOGICAL_DATA_WIDTH; rd_bit_a = rd_bit_a + 1) begin
+            if (burst_hit_a) begin
+                // Serve the word from the latched row, the array is not accessed
+                array_out_a[rd_bit_a] = row_buf_a[get_phys_col(eff_addr_a, rd_bit_a)];
+            end else if (get_phys_col(eff_addr_a, rd_bit_a) < PHYSICAL_COLS) begin
+                // Read logical data from individual physical cells
+                array_out_a[rd_bit_a] = cell_array[get_phys_row(eff_addr_a)][get_phys_col(eff_addr_a, rd_bit_a)];
+            end else begin
+                array_out_a[rd_bit_a] = 1'b0; // Default to 0 for out-of-bounds
+            end
+        end
+    end
+
+    always @(*) begin
+        for (rd_bit_b = 0; rd_bit_b < LOGICAL_DATA_WIDTH; rd_bit_b = rd_bit_b + 1) begin
+            if (burst_hit_b) begin
+                array_out_b[rd_bit_b] = row_buf_b[get_phys_col(eff_addr_b, rd_bit_b)];
+            end else if (get_phys_col(eff_addr_b, rd_bit_b) < PHYSICAL_COLS) begin
+                array_out_b[rd_bit_b] = cell_array[get_phys_row(eff_addr_b)][get_phys_col(eff_addr_b, rd_bit_b)];
+            end else begin
+                array_out_b[rd_bit_b] = 1'b0;
+            end
+        end
+    end
+
+    // Transposed bit read: every column activates its own row through its wordline segment
+    integer bit_rd_row;
+    always @(*) begin
+        bit_array_out = {PHYSICAL_ROWS{1'b0}};
+        for (bit_rd_row = 0; bit_rd_row < BIT_TILE_ROWS; bit_rd_row = bit_rd_row + 1) begin
+            bit_array_out[bit_rd_row] = cell_array[bit_rd_row][bit_tile_col(bit_rd_row, r_bit_raddr)];
+        end
+    end
+
+    // Bit-transpose port access logic
+    integer bit_wr_col;
+    always @(posedge clk) begin
+        if (!rst) begin
+            if (r_bit_wen) begin
+                // One wordline, the row is rotated onto the columns by the write crossbar
+                for (bit_wr_col = 0; bit_wr_col < BIT_TILE_COLS; bit_wr_col = bit_wr_col + 1) begin
+                    cell_array[r_bit_waddr][bit_tile_col(r_bit_waddr, bit_wr_col)] <= r_bit_wdata[bit_wr_col];
+                end
+            end
+            if (r_bit_ren) begin
+                bit_rd_data <= bit_array_out;
+            end
+        end
+    end
+
     // Port A access logic
     always @(posedge clk) begin
         if (!rst) begin
             if (r_wen_a | r_ren_a) begin
                 // Decode logical address to physical coordinates
-                phys_row_a = get_phys_row(r_addr_a);
-                col_start_a = get_phys_col(r_addr_a);
+                phys_row_a = get_phys_row(eff_addr_a);
                 
                 if (r_wen_a) begin
-                    // Write logical data to individual physical cells
+                    // Write logical data to individual physical cells, skipping disabled byte lanes
                     for (bit_idx_a = 0; bit_idx_a < LOGICAL_DATA_WIDTH; bit_idx_a = bit_idx_a + 1) begin
-                        if ((col_start_a + bit_idx_a) < PHYSICAL_COLS) begin
-                            cell_array[phys_row_a][col_start_a + bit_idx_a] <= r_data_in_a[bit_idx_a];
+                        if (r_be_a[bit_idx_a / BYTE_LANE_WIDTH] && get_phys_col(eff_addr_a, bit_idx_a) < PHYSICAL_COLS) begin
+                            cell_array[phys_row_a][get_phys_col(eff_addr_a, bit_idx_a)] <= r_data_in_a[bit_idx_a];
                         end
                     end
                 end
                 
                 if (r_ren_a) begin
-                    // Read logical data from individual physical cells
-                    for (bit_idx_a = 0; bit_idx_a < LOGICAL_DATA_WIDTH; bit_idx_a = bit_idx_a + 1) begin
-                        if ((col_start_a + bit_idx_a) < PHYSICAL_COLS) begin
-                            data_out_a[bit_idx_a] <= cell_array[phys_row_a][col_start_a + bit_idx_a];
-                        end else begin
-                            data_out_a[bit_idx_a] <= 1'b0; // Default to 0 for out-of-bounds
+                    rd_data_a <= array_out_a;
+
+                    if (burst_fill_a) begin
+                        // Latch the whole physical row for the rest of the burst
+                        for (col_idx_a = 0; col_idx_a < PHYSICAL_COLS; col_idx_a = col_idx_a + 1) begin
+                            row_buf_a[col_idx_a] <= cell_array[phys_row_a][col_idx_a];
                         end
+                        row_buf_row_a <= phys_row_a;
+                        row_buf_valid_a <= 1'b1;
                     end
                 end
             end
+
+            burst_active_a <= burst_rd_a;
+            burst_addr_a <= eff_addr_a + 1'b1;
+
+            // Drop the row buffer when either port writes the buffered row (including a write
+            // landing in the same cycle as the fill, which latched the old data)
+            if ((r_wen_a && get_phys_row(eff_addr_a) == row_buf_next_a) ||
+                (r_wen_b && get_phys_row(eff_addr_b) == row_buf_next_a) ||
+                (r_bit_wen && r_bit_waddr == row_buf_next_a)) begin
+                row_buf_valid_a <= 1'b0;
+            end
+        end else begin
+            burst_active_a <= 1'b0;
+            row_buf_valid_a <= 1'b0;
         end
     end
     
@@ -156,35 +443,48 @@ module m20k_bram_core #(
     always @(posedge clk) begin
         if (!rst) begin
             if (r_wen_b | r_ren_b) begin
-                phys_row_b = get_phys_row(r_addr_b);
-                col_start_b = get_phys_col(r_addr_b);
+                phys_row_b = get_phys_row(eff_addr_b);
                 
                 if (r_wen_b) begin
-                    // Write logical data to individual physical cells
+                    // Write logical data to individual physical cells, skipping disabled byte lanes
                     for (bit_idx_b = 0; bit_idx_b < LOGICAL_DATA_WIDTH; bit_idx_b = bit_idx_b + 1) begin
-                        if ((col_start_b + bit_idx_b) < PHYSICAL_COLS) begin
-                            cell_array[phys_row_b][col_start_b + bit_idx_b] <= data_in_b[bit_idx_b];
+                        if (r_be_b[bit_idx_b / BYTE_LANE_WIDTH] && get_phys_col(eff_addr_b, bit_idx_b) < PHYSICAL_COLS) begin
+                            cell_array[phys_row_b][get_phys_col(eff_addr_b, bit_idx_b)] <= r_data_in_b[bit_idx_b];
                         end
                     end
                 end
                 
                 if (r_ren_b) begin
-                    // Read logical data from individual physical cells
-                    for (bit_idx_b = 0; bit_idx_b < LOGICAL_DATA_WIDTH; bit_idx_b = bit_idx_b + 1) begin
-                        if ((col_start_b + bit_idx_b) < PHYSICAL_COLS) begin
-                            data_out_b[bit_idx_b] <= cell_array[phys_row_b][col_start_b + bit_idx_b];
-                        end else begin
-                            data_out_b[bit_idx_b] <= 1'b0;
+                    rd_data_b <= array_out_b;
+
+                    if (burst_fill_b) begin
+                        for (col_idx_b = 0; col_idx_b < PHYSICAL_COLS; col_idx_b = col_idx_b + 1) begin
+                            row_buf_b[col_idx_b] <= cell_array[phys_row_b][col_idx_b];
                         end
+                        row_buf_row_b <= phys_row_b;
+                        row_buf_valid_b <= 1'b1;
                     end
                 end
             end
+
+            burst_active_b <= burst_rd_b;
+            burst_addr_b <= eff_addr_b + 1'b1;
+
+            if ((r_wen_a && get_phys_row(eff_addr_a) == row_buf_next_b) ||
+                (r_wen_b && get_phys_row(eff_addr_b) == row_buf_next_b) ||
+                (r_bit_wen && r_bit_waddr == row_buf_next_b)) begin
+                row_buf_valid_b <= 1'b0;
+            end
+        end else begin
+            burst_active_b <= 1'b0;
+            row_buf_valid_b <= 1'b0;
         end
     end
     
     // Conservative assumption: for now, assume diff logical address on same physical row is a collision
-    reg collision = (r_wen_a | r_ren_a) && (r_wen_b | r_ren_b) && 
-                     (get_phys_row(r_addr_a) == get_phys_row(r_addr_b)) &&
+    // Burst reads served from a row buffer don't access the array, so they can't collide
+    wire collision = (r_wen_a | (r_ren_a & ~burst_hit_a)) && (r_wen_b | (r_ren_b & ~burst_hit_b)) && 
+                     (get_phys_row(eff_addr_a) == get_phys_row(eff_addr_b)) &&
                      (r_wen_a | r_wen_b);  // At least one write
     
     // Debug: print registered inputs and collision status
@@ -192,15 +492,15 @@ module m20k_bram_core #(
     always @(posedge clk) begin
         if (collision) begin
             $display("WARNING: Memory collision detected at physical row %d (addr_a=%d, addr_b=%d)", 
-                     get_phys_row(r_addr_a), r_addr_a, r_addr_b);
+                     get_phys_row(eff_addr_a), eff_addr_a, eff_addr_b);
         end
         if (r_wen_a) begin
-            $display("Physical Write Port A: Row=%d, Col_Start=%d, Width=%d, Data=%h", 
-                     get_phys_row(r_addr_a), get_phys_col(r_addr_a), LOGICAL_DATA_WIDTH, r_data_in_a);
+            $display("Physical Write Port A: Row=%d, Col_Start=%d, Col_Stride=%d, Width=%d, Data=%h, BE=%b", 
+                     get_phys_row(r_addr_a), get_phys_col(r_addr_a, 0), MUX_INTERLEAVE, LOGICAL_DATA_WIDTH, r_data_in_a, r_be_a);
         end
         if (r_wen_b) begin
-            $display("Physical Write Port B: Row=%d, Col_Start=%d, Width=%d, Data=%h", 
-                     get_phys_row(r_addr_b), get_phys_col(r_addr_b), LOGICAL_DATA_WIDTH, r_data_in_b);
+            $display("Physical Write Port B: Row=%d, Col_Start=%d, Col_Stride=%d, Width=%d, Data=%h, BE=%b", 
+                     get_phys_row(r_addr_b), get_phys_col(r_addr_b, 0), MUX_INTERLEAVE, LOGICAL_DATA_WIDTH, r_data_in_b, r_be_b);
         end
     end
     `endif
@@ -222,12 +522,29 @@ module m20k_bram_core #(
             
         // Check that column access is within bounds
         if (wen_a || ren_a)
-            assert((get_phys_col(addr_a) + LOGICAL_DATA_WIDTH) <= PHYSICAL_COLS) 
+            assert(get_phys_col(addr_a, LOGICAL_DATA_WIDTH-1) < PHYSICAL_COLS) 
                 else $error("Physical column A access out of bounds");
         if (wen_b || ren_b)
-            assert((get_phys_col(addr_b) + LOGICAL_DATA_WIDTH) <= PHYSICAL_COLS) 
+            assert(get_phys_col(addr_b, LOGICAL_DATA_WIDTH-1) < PHYSICAL_COLS) 
                 else $error("Physical column B access out of bounds");
+
+        // Bit-transpose accesses stay inside the tile and don't share the array with ports A/B
+        if (bit_wen)
+            assert(bit_waddr < BIT_TILE_ROWS) else $error("Bit tile row out of bounds");
+        if (bit_ren)
+            assert(bit_raddr < BIT_TILE_COLS) else $error("Bit tile column out of bounds");
+        if (bit_wen || bit_ren)
+            assert(!(wen_a || ren_a || wen_b || ren_b)) else $error("Bit-transpose access while ports A/B are busy");
+        assert(!(bit_wen && bit_ren)) else $error("Bit-transpose port can't write and read in the same cycle");
     end
     `endif
 
+    // The skew needs a distinct column for every tile row, and the tile must fit in the array
+    generate
+        if (BIT_TILE_ROWS > BIT_TILE_COLS || BIT_TILE_ROWS > PHYSICAL_ROWS || BIT_TILE_COLS > PHYSICAL_COLS) begin : bit_tile_check
+            initial $fatal(1, "m20k_bram_partial_wordlines: bit tile must be at most %0d x %0d with BIT_TILE_ROWS <= BIT_TILE_COLS",
+                           PHYSICAL_ROWS, PHYSICAL_COLS);
+        end
+    endgenerate
+
 endmodule
\ No newline at end of file
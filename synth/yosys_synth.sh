@@ -0,0 +1,62 @@
+#!/bin/sh
+# Area and depth estimate of one configuration with Yosys, appended as a row to a CSV.
+#
+# usage: yosys_synth.sh <csv> <top> "<PARAM=value ...>" <verilog sources...>
+#
+# The design is flattened and synthesized generically: memories are inferred and left as memory cells
+# (counted as BRAMs, with their bits), the rest is mapped to 6-input LUTs and single-bit flip-flops.
+# Logic depth is the longest LUT path between flip-flops, memories and ports. Logs and the full stat
+# reports go to <csv dir>/logs/.
+#
+# CSV columns: design, config, luts, ffs, brams, memory_bits, logic_depth.
+
+set -e
+
+csv=$1
+top=$2
+params=$3
+shift 3
+
+config=$(echo "$params" | tr ' ' ';')
+name="$top${config:+_}$(echo "$config" | tr ';=' '__')"
+logs=$(dirname "$csv")/logs
+mkdir -p "$logs"
+
+chparam=""
+for p in $params; do
+    chparam="$chparam -set ${p%%=*} ${p#*=}"
+done
+
+yosys -q -l "$logs/$name.log" -p "
+read_verilog -sv $*
+${chparam:+chparam$chparam $top}
+synth -top $top -flatten -run :fine
+hierarchy -top $top
+tee -o $logs/$name.memories.txt stat
+opt -fast -full
+techmap
+opt -fast
+abc -lut 6
+opt -fast
+tee -o $logs/$name.stat.txt stat
+delete t:\$mem t:\$mem_v2
+tee -o $logs/$name.ltp.txt ltp -noff
+"
+
+# stat's layout differs between Yosys versions ('Number of cells: N' or 'N cells'), so take the first
+# integer on the line that names the cell type or quantity
+count() {
+    awk -v pattern="$1" '
+        { for (i = 1; i <= NF; i++) if ($i ~ pattern) { for (j = 1; j <= NF; j++) if ($j ~ /^[0-9]+$/) { n += $j; break }; break } }
+        END { print n + 0 }' "$2"
+}
+
+luts=$(count '^[$]lut$' "$logs/$name.stat.txt")
+ffs=$(count '^[$]_(S?DFF|ALDFF|DLATCH)' "$logs/$name.stat.txt")
+brams=$(count '^[$]mem(_v2)?$' "$logs/$name.memories.txt")
+memory_bits=$(grep -i 'memory bits' "$logs/$name.memories.txt" | grep -o '[0-9][0-9]*' | head -n 1)
+depth=$(grep -o 'length=[0-9]*' "$logs/$name.ltp.txt" | head -n 1 | cut -d= -f2)
+
+[ -f "$csv" ] || echo "design,config,luts,ffs,brams,memory_bits,logic_depth" > "$csv"
+echo "$top,${config:-default},$luts,$ffs,$brams,${memory_bits:-0},${depth:-0}" >> "$csv"
+echo "[synth] $top ${params:-default}: $luts LUTs, $ffs FFs, $brams BRAMs ($memory_bits bits), depth $depth"
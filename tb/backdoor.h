@@ -0,0 +1,181 @@
+#ifndef BACKDOOR_H
+#define BACKDOOR_H
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <svdpi.h>
+#include <verilated.h>
+
+// Backdoor access to the memories of the Verilated models: bulk preload and dump of m20k_bram_core's
+// cell array and of the engine's bram_mem instances without simulating any cycles, and $readmemh files
+// for the rtl's INIT_FILE / BRAM_INIT_PREFIX parameters.
+//
+// The rtl side is compiled with +define+TB_BACKDOOR (ver_transpose, ver_ram and ver_cascade do). Every memory
+// instance then registers its DPI scope from an initial block, keyed by its VerilatedContext, so
+// concurrent models (parallel regressions) keep their own. Include this header in one translation unit
+// per executable, it defines the registration function the rtl imports.
+
+enum BackdoorKind {
+    BACKDOOR_BRAM_MEM = 0,      // bram_mem, index = INSTANCE_ID (the engine's bank number)
+    BACKDOOR_M20K = 1,          // m20k_bram_core, index = INSTANCE_ID (m20k_cascade: deep * NUM_WIDE + wide)
+    BACKDOOR_CIRCULANT = 2      // circulant_barrel_shifter_v2's zero bitmap
+};
+
+// Exported by the rtl
+extern "C" {
+void bram_mem_backdoor_write(int addr, long long data);
+long long bram_mem_backdoor_read(int addr);
+void m20k_backdoor_write(int addr, long long data);
+long long m20k_backdoor_read(int addr);
+svBit m20k_backdoor_read_cell(int row, int col);
+void circulant_backdoor_set_row_nonzero(int row, svBit nonzero);
+}
+
+typedef std::tuple<const VerilatedContext*, int, int> BackdoorKey;
+
+inline std::map<BackdoorKey, svScope>& backdoor_scopes() {
+    static std::map<BackdoorKey, svScope> scopes;
+    return scopes;
+}
+
+inline std::mutex& backdoor_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Imported by the rtl, called from each instance's initial block during the model's first eval
+extern "C" void tb_backdoor_register(int kind, int index) {
+    std::lock_guard<std::mutex> lock(backdoor_mutex());
+    backdoor_scopes()[BackdoorKey(Verilated::threadContextp(), kind, index)] = svGetScope();
+}
+
+// Make an instance the target of the next backdoor call. Instances register on the first eval, which
+// also runs the initial blocks that would overwrite a preload, so a model that wasn't evaluated yet is
+// evaluated once here. Returns false if the instance doesn't exist.
+template<typename DUT>
+bool backdoor_select(DUT* dut, BackdoorKind kind, int index = 0) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        {
+            std::lock_guard<std::mutex> lock(backdoor_mutex());
+            auto it = backdoor_scopes().find(BackdoorKey(dut->contextp(), kind, index));
+            if (it != backdoor_scopes().end()) {
+                svSetScope(it->second);
+                return true;
+            }
+        }
+        if (attempt == 0) dut->eval();
+    }
+    return false;
+}
+
+// =============== M20K ===============
+
+// Write logical words starting at base, through the same address mapping as the ports. index picks the
+// block when the model has several (m20k_cascade).
+template<typename DUT>
+bool m20k_backdoor_preload(DUT* dut, uint32_t base, const std::vector<uint64_t>& words, int index = 0) {
+    if (!backdoor_select(dut, BACKDOOR_M20K, index)) return false;
+    for (size_t i = 0; i < words.size(); i++) m20k_backdoor_write(base + i, words[i]);
+    return true;
+}
+
+template<typename DUT>
+std::vector<uint64_t> m20k_backdoor_dump(DUT* dut, uint32_t base, uint32_t count, int index = 0) {
+    std::vector<uint64_t> words;
+    if (!backdoor_select(dut, BACKDOOR_M20K, index)) return words;
+    for (uint32_t i = 0; i < count; i++) words.push_back(m20k_backdoor_read(base + i));
+    return words;
+}
+
+// The cells of one physical row, column 0 first, as they sit in the array (no address mapping)
+template<typename DUT>
+std::vector<uint8_t> m20k_backdoor_dump_row(DUT* dut, int row, int cols, int index = 0) {
+    std::vector<uint8_t> cells;
+    if (!backdoor_select(dut, BACKDOOR_M20K, index)) return cells;
+    for (int col = 0; col < cols; col++) cells.push_back(m20k_backdoor_read_cell(row, col));
+    return cells;
+}
+
+// =============== Transpose engine ===============
+
+// Store a tile the way row writes would: element (row, col) in bank (col + skew_stride * row) mod dim at
+// address row, and the zero bitmap updated to match
+template<typename DUT, typename Tile>
+bool circulant_backdoor_load_tile(DUT* dut, const Tile& tile, int skew_stride) {
+    int dim = tile.size();
+    for (int row = 0; row < dim; row++) {
+        bool nonzero = false;
+        for (int col = 0; col < dim; col++) {
+            int bank = (col + skew_stride * row) % dim;
+            if (!backdoor_select(dut, BACKDOOR_BRAM_MEM, bank)) return false;
+            bram_mem_backdoor_write(row, tile[row][col]);
+            nonzero |= tile[row][col] != 0;
+        }
+        if (!backdoor_select(dut, BACKDOOR_CIRCULANT)) return false;
+        circulant_backdoor_set_row_nonzero(row, nonzero);
+    }
+    return true;
+}
+
+// The stored tile as held by the BRAMs. Rows skipped as all zero read back whatever the BRAMs hold.
+template<typename DUT>
+std::vector<std::vector<uint64_t>> circulant_backdoor_dump_tile(DUT* dut, int dim, int skew_stride) {
+    std::vector<std::vector<uint64_t>> tile(dim, std::vector<uint64_t>(dim));
+    for (int bank = 0; bank < dim; bank++) {
+        if (!backdoor_select(dut, BACKDOOR_BRAM_MEM, bank)) return {};
+        for (int row = 0; row < dim; row++) {
+            int col = ((bank - skew_stride * row) % dim + dim) % dim;
+            tile[row][col] = bram_mem_backdoor_read(row);
+        }
+    }
+    return tile;
+}
+
+// =============== $readmemh files ===============
+
+inline bool write_hex_file(const std::string& path, const std::vector<uint64_t>& words, int bits) {
+    std::ofstream file(path);
+    if (!file) return false;
+    file << std::hex << std::setfill('0');
+    for (uint64_t word : words) file << std::setw((bits + 3) / 4) << word << "\n";
+    return bool(file);
+}
+
+// Reads the subset of the $readmemh format written above: one hex word per line, // comments
+inline std::vector<uint64_t> read_hex_file(const std::string& path) {
+    std::vector<uint64_t> words;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find("//"));
+        std::istringstream fields(line);
+        std::string field;
+        while (fields >> field) words.push_back(std::stoull(field, nullptr, 16));
+    }
+    return words;
+}
+
+// Per-bank init files for circulant_barrel_shifter_v2's BRAM_INIT_PREFIX, holding the given tile
+template<typename Tile>
+bool write_circulant_init_files(const std::string& prefix, const Tile& tile, int skew_stride, int mem_width) {
+    int dim = tile.size();
+    for (int bank = 0; bank < dim; bank++) {
+        std::vector<uint64_t> words(dim);
+        for (int row = 0; row < dim; row++) {
+            words[row] = tile[row][((bank - skew_stride * row) % dim + dim) % dim];
+        }
+        std::ostringstream path;
+        path << prefix << "_" << std::setw(3) << std::setfill('0') << bank << ".hex";
+        if (!write_hex_file(path.str(), words, mem_width)) return false;
+    }
+    return true;
+}
+
+#endif
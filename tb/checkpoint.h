@@ -0,0 +1,115 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+
+// Snapshot a prepared simulation (after reset, preloads, filled tiles...) to disk and restore it for
+// each later scenario instead of redoing the warm-up. Needs the model built with Verilator's --savable
+// (make ... SAVABLE=1, which also defines TB_SAVABLE); otherwise the functions report that checkpoints
+// are unavailable and the testbenches skip their checkpoint tests.
+//
+// A checkpoint holds the DUT state, the testbench's simulation time and a reference memory (address ->
+// data), since the testbench's expectations have to be restored along with the hardware.
+
+#ifdef TB_SAVABLE
+#include <verilated_save.h>
+
+const bool CHECKPOINTS_AVAILABLE = true;
+
+template<typename DUT>
+bool save_checkpoint(const std::string& path, DUT* dut, uint64_t sim_time,
+                     const std::map<uint32_t, uint32_t>& ref_memory) {
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) return false;
+    uint64_t entries = ref_memory.size();
+    os << sim_time << entries;
+    for (const auto& entry : ref_memory) {
+        // The serializer only takes non-const references
+        uint32_t addr = entry.first;
+        uint32_t data = entry.second;
+        os << addr << data;
+    }
+    os << *dut;
+    os.close();
+    return true;
+}
+
+template<typename DUT>
+bool restore_checkpoint(const std::string& path, DUT* dut, uint64_t& sim_time,
+                        std::map<uint32_t, uint32_t>& ref_memory) {
+    VerilatedRestore is;
+    is.open(path.c_str());
+    if (!is.isOpen()) return false;
+    uint64_t entries;
+    is >> sim_time >> entries;
+    ref_memory.clear();
+    for (uint64_t i = 0; i < entries; i++) {
+        uint32_t addr, data;
+        is >> addr >> data;
+        ref_memory[addr] = data;
+    }
+    is >> *dut;
+    is.close();
+    return true;
+}
+
+#else
+
+const bool CHECKPOINTS_AVAILABLE = false;
+
+template<typename DUT>
+bool save_checkpoint(const std::string&, DUT*, uint64_t, const std::map<uint32_t, uint32_t>&) {
+    return false;
+}
+
+template<typename DUT>
+bool restore_checkpoint(const std::string&, DUT*, uint64_t&, std::map<uint32_t, uint32_t>&) {
+    return false;
+}
+
+#endif
+
+// Snapshot of a --regress worker's prepared state: saved once after the worker's warm-up and restored
+// at the start of every seed, so a case starts from the same state whichever cases ran on the worker
+// before it, and skips re-establishing it. Each worker gets its own file, removed with the worker.
+// Without checkpoints save() and restore() return false and the worker carries its state over.
+class WorkerCheckpoint {
+private:
+    std::string path;
+    bool saved;
+
+public:
+    explicit WorkerCheckpoint(const std::string& stem) : saved(false) {
+        static std::atomic<int> next_id(0);
+        path = stem + "_" + std::to_string(next_id++) + ".ckpt";
+    }
+
+    ~WorkerCheckpoint() {
+        if (saved) std::remove(path.c_str());
+    }
+
+    template<typename DUT>
+    bool save(DUT* dut, const std::map<uint32_t, uint32_t>& ref_memory = std::map<uint32_t, uint32_t>()) {
+        saved = save_checkpoint(path, dut, 0, ref_memory);
+        return saved;
+    }
+
+    template<typename DUT>
+    bool restore(DUT* dut, std::map<uint32_t, uint32_t>& ref_memory) {
+        uint64_t sim_time;
+        return saved && restore_checkpoint(path, dut, sim_time, ref_memory);
+    }
+
+    template<typename DUT>
+    bool restore(DUT* dut) {
+        std::map<uint32_t, uint32_t> ref_memory;
+        return restore(dut, ref_memory);
+    }
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CLOCK_DRIVER_H
+#define CLOCK_DRIVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Shared clock driver for the single-clock Verilator testbenches.
+// A cycle is two evals, the least Verilator needs to see a rising edge: clk=1 evaluates the edge
+// (inputs set since the last cycle settle in the same eval and are sampled by it), clk=0 arms the next
+// edge. Outputs are read between the two, or after the cycle since nothing triggers on the falling edge.
+template<typename DUT>
+class ClockDriver {
+private:
+    DUT* dut;
+    uint64_t cycle_count;
+
+public:
+    // Called after every rising edge of tick(), e.g. to sample a PerfMonitor. Not called by run().
+    std::function<void()> on_edge;
+    // Called after every rising edge of both tick() and run(), e.g. to record a stimulus trace of every
+    // cycle the DUT sees. Left empty it costs run() a branch per cycle.
+    std::function<void()> on_cycle;
+
+    explicit ClockDriver(DUT* dut) : dut(dut), cycle_count(0) {
+        dut->clk = 0;
+    }
+
+    void tick() {
+        dut->clk = 1;
+        dut->eval();
+        if (on_edge) on_edge();
+        if (on_cycle) on_cycle();
+        dut->clk = 0;
+        dut->eval();
+        cycle_count++;
+    }
+
+    void tick(int n) {
+        for (int i = 0; i < n; i++) tick();
+    }
+
+    // Batched cycles: apply(dut, stimulus[i]) sets the inputs of cycle i and capture(dut, outputs[i])
+    // records the outputs after its rising edge. Everything is preloaded, so the loop is only the
+    // stimulus copy, the two evals, the capture and the on_cycle check.
+    template<typename Stim, typename Out, typename Apply, typename Capture>
+    void run(size_t n, const Stim* stimulus, Out* outputs, Apply apply, Capture capture) {
+        for (size_t i = 0; i < n; i++) {
+            apply(dut, stimulus[i]);
+            dut->clk = 1;
+            dut->eval();
+            capture(dut, outputs[i]);
+            if (on_cycle) on_cycle();
+            dut->clk = 0;
+            dut->eval();
+        }
+        cycle_count += n;
+    }
+
+    template<typename Stim, typename Out, typename Apply, typename Capture>
+    void run(const std::vector<Stim>& stimulus, std::vector<Out>& outputs, Apply apply, Capture capture) {
+        outputs.resize(stimulus.size());
+        run(stimulus.size(), stimulus.data(), outputs.data(), apply, capture);
+    }
+
+    uint64_t cycles() const { return cycle_count; }
+};
+
+// Simulated cycles per wall-clock second of running body, which must simulate the given cycles
+template<typename Body>
+double measure_cycles_per_second(uint64_t cycles, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() > 0 ? cycles / elapsed.count() : 0.0;
+}
+
+// Print the cycles/s of the sim_speed tests' three loops, each relative to the reference: the DUT
+// clocked the way the testbench did before ClockDriver, tick() with its on_edge hooks, and run()
+inline void report_sim_speed(double reference_rate, double stepwise_rate, double batched_rate) {
+    auto line = [&](const char* name, double rate) {
+        std::cout << name << std::fixed << std::setprecision(0) << std::setw(12) << rate << " cycles/s ("
+                  << std::setprecision(2) << (reference_rate > 0 ? rate / reference_rate : 0.0) << "x)"
+                  << std::defaultfloat << std::endl;
+    };
+    line("Reference (old clocking, no hooks): ", reference_rate);
+    line("Stepwise tick() with hooks:         ", stepwise_rate);
+    line("Batched run():                      ", batched_rate);
+}
+
+#endif
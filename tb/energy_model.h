@@ -0,0 +1,108 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+// Activity-based energy model for the BRAM transpose designs.
+// The RTL models count wordline activations, bitlines sensed and cells written; this file
+// turns those counts into an energy estimate so designs can be compared per transposed element.
+//
+// Energies are in relative units (1.0 = one bitline precharged and discharged by an activated
+// wordline). They are placeholders to compare designs against each other, not absolute pJ figures.
+
+// Physical M20K organization (CoMeFa), matches m20k_bram_core
+const int M20K_PHYSICAL_COLS = 160;
+const int M20K_PHYSICAL_ROWS = 128;
+const int M20K_COL_MUX_FACTOR = 4;
+
+struct EnergyParams {
+    double e_wl_col = 1.0;  // Per column spanned by an activated wordline (bitline swing + wordline drive)
+    double e_sense = 0.5;   // Per bitline read through a sense amp
+    double e_write = 1.5;   // Per bit cell written (write driver swing)
+};
+
+struct ActivityCounts {
+    uint64_t wl_activations = 0;  // Number of wordlines (or wordline segments) driven
+    uint64_t wl_columns = 0;      // Total columns spanned by those wordlines
+    uint64_t bitlines_sensed = 0;
+    uint64_t cells_written = 0;
+
+    ActivityCounts operator-(const ActivityCounts& other) const {
+        ActivityCounts diff;
+        diff.wl_activations = wl_activations - other.wl_activations;
+        diff.wl_columns = wl_columns - other.wl_columns;
+        diff.bitlines_sensed = bitlines_sensed - other.bitlines_sensed;
+        diff.cells_written = cells_written - other.cells_written;
+        return diff;
+    }
+};
+
+// Build counts from the RTL counters. Every wordline in a conventional BRAM spans the full row.
+inline ActivityCounts activity_from_counters(uint32_t wl_activations, uint32_t bitlines_sensed,
+                                             uint32_t cells_written, int cols_per_wordline = M20K_PHYSICAL_COLS) {
+    ActivityCounts counts;
+    counts.wl_activations = wl_activations;
+    counts.wl_columns = uint64_t(wl_activations) * cols_per_wordline;
+    counts.bitlines_sensed = bitlines_sensed;
+    counts.cells_written = cells_written;
+    return counts;
+}
+
+// Counts of m20k_bram_partial_wordlines' bit-transpose port. Its counters don't tell wordlines from
+// segments, so they are split using the tile shape: every tile row write drives one wordline across
+// tile_cols columns (cells_written / tile_cols of them), every other activation is a one-column segment.
+inline ActivityCounts activity_from_bit_tile_counters(uint32_t wl_activations, uint32_t bitlines_sensed,
+                                                      uint32_t cells_written, int tile_cols) {
+    ActivityCounts counts;
+    uint64_t row_writes = cells_written / tile_cols;
+    counts.wl_activations = wl_activations;
+    counts.wl_columns = row_writes * tile_cols + (wl_activations - row_writes);
+    counts.bitlines_sensed = bitlines_sensed;
+    counts.cells_written = cells_written;
+    return counts;
+}
+
+// Estimated activity of transposing a dim x dim tile inside one partial-wordline M20K. This is a
+// closed-form estimate: the partial-wordline model only has a bit-transpose port (1-bit elements, no
+// column multiplexing), where tb_m20k_partial_wordlines checks it against the measured counters.
+// Rows are stored circulant-skewed along a single physical row, so a row write drives one wordline
+// across the columns holding the row. A transposed read drives dim wordline segments (one per element),
+// each on a different physical row. With column multiplexing the bits of an element are interleaved
+// col_mux columns apart, so each segment spans elem_width * col_mux columns.
+inline ActivityCounts partial_wordline_transpose_activity(int dim, int elem_width,
+                                                          int col_mux = M20K_COL_MUX_FACTOR) {
+    ActivityCounts counts;
+    uint64_t elements = uint64_t(dim) * dim;
+    uint64_t segment_cols = uint64_t(elem_width) * col_mux;
+    uint64_t row_cols = std::min<uint64_t>(dim * segment_cols, M20K_PHYSICAL_COLS);
+    counts.wl_activations = dim + elements;
+    counts.wl_columns = dim * row_cols + elements * segment_cols;
+    counts.bitlines_sensed = elements * elem_width;
+    counts.cells_written = elements * elem_width;
+    return counts;
+}
+
+inline double estimate_energy(const ActivityCounts& counts, const EnergyParams& params = EnergyParams()) {
+    return counts.wl_columns * params.e_wl_col +
+           counts.bitlines_sensed * params.e_sense +
+           counts.cells_written * params.e_write;
+}
+
+inline void print_energy_report(const std::string& label, const ActivityCounts& counts, uint64_t elements,
+                                const EnergyParams& params = EnergyParams()) {
+    double energy = estimate_energy(counts, params);
+    std::cout << label << ":" << std::endl;
+    std::cout << "  Wordline activations: " << counts.wl_activations
+              << " (" << counts.wl_columns << " columns driven)" << std::endl;
+    std::cout << "  Bitlines sensed: " << counts.bitlines_sensed << std::endl;
+    std::cout << "  Cells written: " << counts.cells_written << std::endl;
+    std::cout << "  Energy: " << std::fixed << std::setprecision(1) << energy
+              << " units, " << (elements > 0 ? energy / elements : 0.0)
+              << " units per transposed element" << std::defaultfloat << std::endl;
+}
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef HOST_TRANSPOSE_H
+#define HOST_TRANSPOSE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HOST_TRANSPOSE_X86 1
+#endif
+
+// Host-side matrix transpose, the golden reference for transposes run through the models and the CPU
+// baseline they are compared with. Out of place and cache blocked: dst[c * dst_stride + r] =
+// src[r * src_stride + c] for r < rows, c < cols. Strides are in elements, so sub-matrices of larger
+// buffers can be transposed.
+//
+// On x86, 1/2/4/8 byte elements go through SIMD kernels: an SSE2 kernel transposes a square block of one
+// 16 byte vector per row (16x16 bytes, 8x8 16-bit, 4x4 32-bit, 2x2 64-bit) with log2(rows) rounds of
+// unpacks, and the AVX2 kernel runs the same network on 32 byte rows, i.e. on two neighbouring blocks at
+// once. AVX2 is picked at runtime when the CPU has it, so the testbenches need no -mavx2. Edges that
+// don't fill a kernel block fall back to the scalar loop.
+
+const size_t HOST_TRANSPOSE_BLOCK = 32;    // Cache block, a multiple of every kernel's block
+
+enum HostTransposeIsa {
+    HOST_TRANSPOSE_SCALAR = 0,
+    HOST_TRANSPOSE_SSE2 = 1,
+    HOST_TRANSPOSE_AVX2 = 2
+};
+
+inline const char* host_transpose_isa_name(HostTransposeIsa isa) {
+    switch (isa) {
+    case HOST_TRANSPOSE_SSE2: return "sse2";
+    case HOST_TRANSPOSE_AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+// Best kernel this CPU supports
+inline HostTransposeIsa host_transpose_best_isa() {
+#ifdef HOST_TRANSPOSE_X86
+    static const HostTransposeIsa best = __builtin_cpu_supports("avx2") ? HOST_TRANSPOSE_AVX2 : HOST_TRANSPOSE_SSE2;
+    return best;
+#else
+    return HOST_TRANSPOSE_SCALAR;
+#endif
+}
+
+template<typename T>
+void host_transpose_scalar(const T* src, size_t src_stride, T* dst, size_t dst_stride, size_t rows, size_t cols) {
+    for (size_t r0 = 0; r0 < rows; r0 += HOST_TRANSPOSE_BLOCK) {
+        size_t r1 = std::min(rows, r0 + HOST_TRANSPOSE_BLOCK);
+        for (size_t c0 = 0; c0 < cols; c0 += HOST_TRANSPOSE_BLOCK) {
+            size_t c1 = std::min(cols, c0 + HOST_TRANSPOSE_BLOCK);
+            for (size_t r = r0; r < r1; r++) {
+                const T* src_row = src + r * src_stride;
+                for (size_t c = c0; c < c1; c++) dst[c * dst_stride + r] = src_row[c];
+            }
+        }
+    }
+}
+
+#ifdef HOST_TRANSPOSE_X86
+
+#define HOST_TRANSPOSE_INLINE inline __attribute__((always_inline))
+#define HOST_TRANSPOSE_AVX2_INLINE inline __attribute__((always_inline, target("avx2")))
+// The kernels' loops must be unrolled for their vectors to stay in registers, -O2 alone doesn't
+#define HOST_TRANSPOSE_UNROLL _Pragma("GCC unroll 16")
+
+// Interleave the low / high halves of two vectors at BYTES granularity
+template<int BYTES> struct HostUnpackSse;
+template<> struct HostUnpackSse<1> {
+    HOST_TRANSPOSE_INLINE static __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi8(a, b); }
+    HOST_TRANSPOSE_INLINE static __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi8(a, b); }
+};
+template<> struct HostUnpackSse<2> {
+    HOST_TRANSPOSE_INLINE static __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi16(a, b); }
+    HOST_TRANSPOSE_INLINE static __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi16(a, b); }
+};
+template<> struct HostUnpackSse<4> {
+    HOST_TRANSPOSE_INLINE static __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi32(a, b); }
+    HOST_TRANSPOSE_INLINE static __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi32(a, b); }
+};
+template<> struct HostUnpackSse<8> {
+    HOST_TRANSPOSE_INLINE static __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi64(a, b); }
+    HOST_TRANSPOSE_INLINE static __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi64(a, b); }
+};
+
+template<int BYTES> struct HostUnpackAvx2;
+template<> struct HostUnpackAvx2<1> {
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i lo(__m256i a, __m256i b) { return _mm256_unpacklo_epi8(a, b); }
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i hi(__m256i a, __m256i b) { return _mm256_unpackhi_epi8(a, b); }
+};
+template<> struct HostUnpackAvx2<2> {
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i lo(__m256i a, __m256i b) { return _mm256_unpacklo_epi16(a, b); }
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i hi(__m256i a, __m256i b) { return _mm256_unpackhi_epi16(a, b); }
+};
+template<> struct HostUnpackAvx2<4> {
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i lo(__m256i a, __m256i b) { return _mm256_unpacklo_epi32(a, b); }
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i hi(__m256i a, __m256i b) { return _mm256_unpackhi_epi32(a, b); }
+};
+template<> struct HostUnpackAvx2<8> {
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i lo(__m256i a, __m256i b) { return _mm256_unpacklo_epi64(a, b); }
+    HOST_TRANSPOSE_AVX2_INLINE static __m256i hi(__m256i a, __m256i b) { return _mm256_unpackhi_epi64(a, b); }
+};
+
+// One block of N = 16 / BYTES rows: row i of the output pairs row i and row i + N/2 of the input, element
+// by element. After log2(N) rounds v[i] holds column i (within each 128-bit lane).
+template<int BYTES>
+HOST_TRANSPOSE_INLINE void host_transpose_block_sse(const uint8_t* src, size_t src_stride, uint8_t* dst,
+                                                    size_t dst_stride) {
+    const int n = 16 / BYTES;
+    __m128i v[n], t[n];
+    HOST_TRANSPOSE_UNROLL
+    for (int i = 0; i < n; i++) v[i] = _mm_loadu_si128((const __m128i*)(src + i * src_stride));
+    HOST_TRANSPOSE_UNROLL
+    for (int round = 1; round < n; round *= 2) {
+        HOST_TRANSPOSE_UNROLL
+        for (int i = 0; i < n / 2; i++) {
+            t[2 * i] = HostUnpackSse<BYTES>::lo(v[i], v[i + n / 2]);
+            t[2 * i + 1] = HostUnpackSse<BYTES>::hi(v[i], v[i + n / 2]);
+        }
+        HOST_TRANSPOSE_UNROLL
+        for (int i = 0; i < n; i++) v[i] = t[i];
+    }
+    HOST_TRANSPOSE_UNROLL
+    for (int i = 0; i < n; i++) _mm_storeu_si128((__m128i*)(dst + i * dst_stride), v[i]);
+}
+
+// Two neighbouring blocks (N rows x 2N columns), the left one in the low lanes
+template<int BYTES>
+__attribute__((target("avx2")))
+void host_transpose_block_avx2(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride) {
+    const int n = 16 / BYTES;
+    __m256i v[n], t[n];
+    HOST_TRANSPOSE_UNROLL
+    for (int i = 0; i < n; i++) v[i] = _mm256_loadu_si256((const __m256i*)(src + i * src_stride));
+    HOST_TRANSPOSE_UNROLL
+    for (int round = 1; round < n; round *= 2) {
+        HOST_TRANSPOSE_UNROLL
+        for (int i = 0; i < n / 2; i++) {
+            t[2 * i] = HostUnpackAvx2<BYTES>::lo(v[i], v[i + n / 2]);
+            t[2 * i + 1] = HostUnpackAvx2<BYTES>::hi(v[i], v[i + n / 2]);
+        }
+        HOST_TRANSPOSE_UNROLL
+        for (int i = 0; i < n; i++) v[i] = t[i];
+    }
+    HOST_TRANSPOSE_UNROLL
+    for (int i = 0; i < n; i++) {
+        _mm_storeu_si128((__m128i*)(dst + i * dst_stride), _mm256_castsi256_si128(v[i]));
+        _mm_storeu_si128((__m128i*)(dst + (n + i) * dst_stride), _mm256_extracti128_si256(v[i], 1));
+    }
+}
+
+// Whole kernel blocks of each cache block, the scalar loop for what's left at the right and bottom edges
+template<typename T>
+void host_transpose_simd(const T* src, size_t src_stride, T* dst, size_t dst_stride, size_t rows, size_t cols,
+                         HostTransposeIsa isa, std::true_type) {
+    const int BYTES = sizeof(T);
+    const size_t n = 16 / BYTES;
+    const size_t kernel_cols = isa == HOST_TRANSPOSE_AVX2 ? 2 * n : n;
+    for (size_t r0 = 0; r0 < rows; r0 += HOST_TRANSPOSE_BLOCK) {
+        size_t r1 = std::min(rows, r0 + HOST_TRANSPOSE_BLOCK);
+        size_t r_full = r0 + (r1 - r0) / n * n;
+        for (size_t c0 = 0; c0 < cols; c0 += HOST_TRANSPOSE_BLOCK) {
+            size_t c1 = std::min(cols, c0 + HOST_TRANSPOSE_BLOCK);
+            size_t c_full = c0 + (c1 - c0) / kernel_cols * kernel_cols;
+            for (size_t r = r0; r < r_full; r += n) {
+                for (size_t c = c0; c < c_full; c += kernel_cols) {
+                    const uint8_t* s = (const uint8_t*)(src + r * src_stride + c);
+                    uint8_t* d = (uint8_t*)(dst + c * dst_stride + r);
+                    if (isa == HOST_TRANSPOSE_AVX2) {
+                        host_transpose_block_avx2<BYTES>(s, src_stride * BYTES, d, dst_stride * BYTES);
+                    } else {
+                        host_transpose_block_sse<BYTES>(s, src_stride * BYTES, d, dst_stride * BYTES);
+                    }
+                }
+            }
+            // Right edge of the full rows, then the bottom edge across the whole cache block
+            host_transpose_scalar(src + r0 * src_stride + c_full, src_stride, dst + c_full * dst_stride + r0,
+                                  dst_stride, r_full - r0, c1 - c_full);
+            host_transpose_scalar(src + r_full * src_stride + c0, src_stride, dst + c0 * dst_stride + r_full,
+                                  dst_stride, r1 - r_full, c1 - c0);
+        }
+    }
+}
+
+// Element sizes without a kernel
+template<typename T>
+void host_transpose_simd(const T* src, size_t src_stride, T* dst, size_t dst_stride, size_t rows, size_t cols,
+                         HostTransposeIsa, std::false_type) {
+    host_transpose_scalar(src, src_stride, dst, dst_stride, rows, cols);
+}
+
+#endif
+
+// Transpose with the given kernel (default: the best one). Element sizes without a SIMD kernel, and
+// every size off x86, use the scalar loop.
+template<typename T>
+void host_transpose(const T* src, size_t src_stride, T* dst, size_t dst_stride, size_t rows, size_t cols,
+                    HostTransposeIsa isa = host_transpose_best_isa()) {
+#ifdef HOST_TRANSPOSE_X86
+    if (isa != HOST_TRANSPOSE_SCALAR) {
+        host_transpose_simd(src, src_stride, dst, dst_stride, rows, cols, isa,
+                            std::integral_constant<bool, sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                                                         sizeof(T) == 8>());
+        return;
+    }
+#endif
+    host_transpose_scalar(src, src_stride, dst, dst_stride, rows, cols);
+}
+
+// Same on raw bytes for 1, 2, 4 or 8 byte elements. Returns false for other widths.
+inline bool host_transpose_bytes(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                                 size_t rows, size_t cols, int elem_bytes,
+                                 HostTransposeIsa isa = host_transpose_best_isa()) {
+    switch (elem_bytes) {
+    case 1: host_transpose(src, src_stride, dst, dst_stride, rows, cols, isa); return true;
+    case 2: host_transpose((const uint16_t*)src, src_stride, (uint16_t*)dst, dst_stride, rows, cols, isa); return true;
+    case 4: host_transpose((const uint32_t*)src, src_stride, (uint32_t*)dst, dst_stride, rows, cols, isa); return true;
+    case 8: host_transpose((const uint64_t*)src, src_stride, (uint64_t*)dst, dst_stride, rows, cols, isa); return true;
+    default: return false;
+    }
+}
+
+// Host throughput on count rows x cols matrices stored back to back, each transposed by its own call (so
+// small tiles pay the per-call overhead the way a tile-at-a-time caller would). Repeats the batch until
+// min_seconds have passed. Returns GB/s of matrix data transposed (as many bytes are written as read).
+inline double host_transpose_gbps(HostTransposeIsa isa, int elem_bytes, size_t rows, size_t cols, size_t count,
+                                  double min_seconds) {
+    size_t matrix_bytes = rows * cols * elem_bytes;
+    std::vector<uint8_t> src(matrix_bytes * count), dst(matrix_bytes * count);
+    for (size_t i = 0; i < src.size(); i++) src[i] = uint8_t(i * 131 + 7);
+    uint64_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed(0);
+    while (elapsed.count() < min_seconds) {
+        for (size_t m = 0; m < count; m++) {
+            host_transpose_bytes(src.data() + m * matrix_bytes, cols, dst.data() + m * matrix_bytes, rows, rows,
+                                 cols, elem_bytes, isa);
+        }
+        bytes += matrix_bytes * count;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    // Keep the stores observable
+    volatile uint8_t sink = dst[dst.size() / 2];
+    (void)sink;
+    return bytes / elapsed.count() / 1e9;
+}
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef MATRIX_FILE_H
+#define MATRIX_FILE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "host_transpose.h"
+
+// Flat binary matrix datasets, memory-mapped so large inputs stream through the transpose harness without
+// being loaded or copied into per-row vectors.
+//
+// File layout: a 32 byte header ("TBMATRX1", u32 rows, u32 cols, u32 element bytes (1, 2, 4 or 8),
+// u32 matrix count, 8 reserved bytes, little-endian), then the matrices back to back, each row-major.
+
+struct MatrixFileHeader {
+    char magic[8];
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t elem_bytes;
+    uint32_t count;
+    uint64_t reserved;
+};
+static_assert(sizeof(MatrixFileHeader) == 32, "matrix file header must be 32 bytes");
+
+class MatrixFile {
+private:
+    uint8_t* map = nullptr;
+    size_t map_size = 0;
+    bool writable = false;
+    MatrixFileHeader header = {};
+
+    bool map_file(const std::string& path, int flags, size_t size) {
+        int fd = ::open(path.c_str(), flags, 0644);
+        if (fd < 0) return false;
+        if (flags & O_CREAT) {
+            if (ftruncate(fd, size) != 0) {
+                ::close(fd);
+                return false;
+            }
+        } else {
+            struct stat st;
+            if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MatrixFileHeader)) {
+                ::close(fd);
+                return false;
+            }
+            size = st.st_size;
+        }
+        int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* addr = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) return false;
+        map = (uint8_t*)addr;
+        map_size = size;
+        return true;
+    }
+
+    // Nonzero dimensions, a supported element size and a matrix size that fits in size_t
+    bool shape_valid() const {
+        return header.rows > 0 && header.cols > 0 &&
+               (header.elem_bytes == 1 || header.elem_bytes == 2 || header.elem_bytes == 4 ||
+                header.elem_bytes == 8) &&
+               uint64_t(header.rows) * header.cols <= SIZE_MAX / header.elem_bytes;
+    }
+
+public:
+    ~MatrixFile() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        writable = false;
+        if (!map_file(path, O_RDONLY, 0)) return false;
+        std::memcpy(&header, map, sizeof(header));
+        // Divide rather than multiply, a header's count * matrix size can overflow
+        bool valid = std::memcmp(header.magic, "TBMATRX1", 8) == 0 && shape_valid() &&
+                     (map_size - sizeof(header)) / matrix_bytes() >= header.count;
+        if (!valid) close();
+        else madvise(map, map_size, MADV_SEQUENTIAL);
+        return valid;
+    }
+
+    bool create(const std::string& path, uint32_t rows, uint32_t cols, uint32_t elem_bytes, uint32_t count) {
+        close();
+        writable = true;
+        header = {};
+        std::memcpy(header.magic, "TBMATRX1", 8);
+        header.rows = rows;
+        header.cols = cols;
+        header.elem_bytes = elem_bytes;
+        header.count = count;
+        if (!shape_valid() || count > (SIZE_MAX - sizeof(header)) / matrix_bytes()) return false;
+        if (!map_file(path, O_RDWR | O_CREAT | O_TRUNC, sizeof(header) + count * matrix_bytes())) return false;
+        std::memcpy(map, &header, sizeof(header));
+        return true;
+    }
+
+    void close() {
+        if (!map) return;
+        if (writable) msync(map, map_size, MS_SYNC);
+        munmap(map, map_size);
+        map = nullptr;
+    }
+
+    bool is_open() const { return map != nullptr; }
+    uint32_t rows() const { return header.rows; }
+    uint32_t cols() const { return header.cols; }
+    uint32_t elem_bytes() const { return header.elem_bytes; }
+    uint32_t count() const { return header.count; }
+    size_t matrix_bytes() const { return size_t(header.rows) * header.cols * header.elem_bytes; }
+    size_t total_bytes() const { return header.count * matrix_bytes(); }
+
+    const uint8_t* data(uint32_t matrix) const { return map + sizeof(header) + matrix * matrix_bytes(); }
+    uint8_t* data(uint32_t matrix) { return map + sizeof(header) + matrix * matrix_bytes(); }
+
+    uint64_t get(uint32_t matrix, uint32_t row, uint32_t col) const {
+        uint64_t value = 0;
+        std::memcpy(&value, data(matrix) + (size_t(row) * header.cols + col) * header.elem_bytes, header.elem_bytes);
+        return value;
+    }
+
+    void set(uint32_t matrix, uint32_t row, uint32_t col, uint64_t value) {
+        std::memcpy(data(matrix) + (size_t(row) * header.cols + col) * header.elem_bytes, &value, header.elem_bytes);
+    }
+
+    // Drop rows that were consumed from the page cache mapping (read-only files), keeping the resident
+    // set bounded on inputs larger than memory
+    void release_rows(uint32_t matrix, uint32_t first_row, uint32_t num_rows) {
+        if (writable) return;
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t start = data(matrix) - map + size_t(first_row) * header.cols * header.elem_bytes;
+        size_t end = start + size_t(num_rows) * header.cols * header.elem_bytes;
+        start = (start + page - 1) / page * page;
+        end = end / page * page;
+        if (end > start) madvise(map + start, end - start, MADV_DONTNEED);
+    }
+};
+
+// Compare every matrix of out against the transpose of the same matrix of in, a band of output rows at a
+// time so the reference stays small. Returns false with details on the first mismatch.
+inline bool verify_matrix_file_transpose(const MatrixFile& in, const MatrixFile& out, std::string& details) {
+    if (out.rows() != in.cols() || out.cols() != in.rows() || out.elem_bytes() != in.elem_bytes() ||
+        out.count() != in.count()) {
+        details = "output dimensions don't match the transposed input";
+        return false;
+    }
+    const uint32_t band = 64;
+    size_t eb = in.elem_bytes();
+    std::vector<uint8_t> expected(size_t(band) * in.rows() * eb);
+    for (uint32_t m = 0; m < in.count(); m++) {
+        for (uint32_t c0 = 0; c0 < in.cols(); c0 += band) {
+            uint32_t n = std::min(band, in.cols() - c0);
+            host_transpose_bytes(in.data(m) + c0 * eb, in.cols(), expected.data(), in.rows(), in.rows(), n, eb);
+            const uint8_t* actual = out.data(m) + size_t(c0) * out.cols() * eb;
+            if (std::memcmp(actual, expected.data(), size_t(n) * out.cols() * eb) != 0) {
+                for (size_t i = 0; i < size_t(n) * out.cols(); i++) {
+                    if (std::memcmp(actual + i * eb, expected.data() + i * eb, eb) != 0) {
+                        details = "matrix " + std::to_string(m) + " output row " + std::to_string(c0 + i / out.cols()) +
+                                  " col " + std::to_string(i % out.cols()) + " differs";
+                        break;
+                    }
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Fill a new file with random elements of value_bits bits
+inline bool write_random_matrix_file(const std::string& path, uint32_t rows, uint32_t cols, uint32_t elem_bytes,
+                                     uint32_t count, int value_bits, uint64_t seed) {
+    MatrixFile file;
+    if (!file.create(path, rows, cols, elem_bytes, count)) return false;
+    std::mt19937_64 rng(seed);
+    uint64_t mask = value_bits >= 64 ? ~0ull : (1ull << value_bits) - 1;
+    for (uint32_t m = 0; m < count; m++) {
+        for (uint32_t r = 0; r < rows; r++) {
+            for (uint32_t c = 0; c < cols; c++) file.set(m, r, c, rng() & mask);
+        }
+    }
+    return true;
+}
+
+struct MatrixFileOptions {
+    std::string in_path;    // --matrix-in=path: transpose the matrices of this file through the model
+    std::string out_path;   // --matrix-out=path: where the transposed matrices go
+};
+
+inline MatrixFileOptions parse_matrix_file_args(int argc, char** argv) {
+    MatrixFileOptions opts;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--matrix-in=", 12) == 0) opts.in_path = argv[i] + 12;
+        else if (std::strncmp(argv[i], "--matrix-out=", 13) == 0) opts.out_path = argv[i] + 13;
+    }
+    return opts;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef PARALLEL_REGRESSION_H
+#define PARALLEL_REGRESSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Seeded random regressions spread over worker threads.
+// Every worker owns its own VerilatedContext and DUT (Verilated models can run concurrently as long as
+// they don't share a context), pulls seeds from a shared queue until it is empty, and merges its
+// pass/fail and cycle counts into the totals at the end.
+//
+// A Worker is constructed once per thread and provides
+//     bool run_case(uint64_t seed, uint64_t& cycles)
+// which runs one self-checking case, adds the cycles it simulated and returns whether it passed.
+// Workers must not print from run_case (output from threads would interleave).
+
+struct RegressionOptions {
+    bool enabled = false;
+    int threads = 0;          // 0 = one per hardware thread
+    uint64_t first_seed = 1;
+    uint64_t num_seeds = 256;
+};
+
+// Parse --regress[=num_seeds], --threads=N and --seed=first_seed. Unknown arguments are left for Verilator.
+inline RegressionOptions parse_regression_args(int argc, char** argv) {
+    RegressionOptions opts;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--regress", 9) == 0) {
+            opts.enabled = true;
+            if (arg[9] == '=') opts.num_seeds = std::strtoull(arg + 10, nullptr, 10);
+        } else if (std::strncmp(arg, "--threads=", 10) == 0) {
+            opts.threads = std::atoi(arg + 10);
+        } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+            opts.first_seed = std::strtoull(arg + 7, nullptr, 10);
+        }
+    }
+    if (opts.threads <= 0) opts.threads = std::max(1u, std::thread::hardware_concurrency());
+    return opts;
+}
+
+struct RegressionStats {
+    uint64_t cases = 0;
+    uint64_t passed = 0;
+    uint64_t cycles = 0;
+    std::vector<uint64_t> failed_seeds;
+
+    void add(uint64_t seed, bool ok, uint64_t case_cycles) {
+        cases++;
+        cycles += case_cycles;
+        if (ok) passed++;
+        else failed_seeds.push_back(seed);
+    }
+
+    void merge(const RegressionStats& other) {
+        cases += other.cases;
+        passed += other.passed;
+        cycles += other.cycles;
+        failed_seeds.insert(failed_seeds.end(), other.failed_seeds.begin(), other.failed_seeds.end());
+    }
+};
+
+// Run seeds [first_seed, first_seed + num_seeds) over the worker threads and print the merged results.
+// Worker(args...) is constructed inside each thread. Returns true if every case passed.
+template<typename Worker, typename... Args>
+bool run_parallel_regression(const std::string& name, const RegressionOptions& opts, Args... args) {
+    std::atomic<uint64_t> next_case(0);
+    std::mutex merge_mutex;
+    RegressionStats total;
+    std::vector<uint64_t> per_thread_cases(opts.threads, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < opts.threads; t++) {
+        threads.emplace_back([&, t] {
+            Worker worker(args...);
+            RegressionStats local;
+            uint64_t i;
+            while ((i = next_case.fetch_add(1)) < opts.num_seeds) {
+                uint64_t seed = opts.first_seed + i;
+                uint64_t cycles = 0;
+                bool ok = worker.run_case(seed, cycles);
+                local.add(seed, ok, cycles);
+            }
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            per_thread_cases[t] = local.cases;
+            total.merge(local);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::sort(total.failed_seeds.begin(), total.failed_seeds.end());
+    std::cout << "\n=== Regression: " << name << " ===" << std::endl;
+    std::cout << "Seeds " << opts.first_seed << ".." << opts.first_seed + opts.num_seeds - 1 << " on "
+              << opts.threads << " thread(s)" << std::endl;
+    std::cout << "Passed: " << total.passed << "/" << total.cases << std::endl;
+    if (!total.failed_seeds.empty()) {
+        std::cout << "Failed seeds:";
+        for (size_t i = 0; i < total.failed_seeds.size() && i < 16; i++) std::cout << " " << total.failed_seeds[i];
+        if (total.failed_seeds.size() > 16) std::cout << " ...";
+        std::cout << std::endl;
+    }
+    std::cout << "Cases per thread:";
+    for (uint64_t cases : per_thread_cases) std::cout << " " << cases;
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << "Wall time: " << elapsed.count() << " s, "
+              << std::setprecision(0) << total.cycles / std::max(elapsed.count(), 1e-9)
+              << " simulated cycles/s across threads" << std::defaultfloat << std::endl;
+    return total.failed_seeds.empty();
+}
+
+#endif
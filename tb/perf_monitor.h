@@ -0,0 +1,229 @@
+#ifndef PERF_MONITOR_H
+#define PERF_MONITOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+
+// Transaction-level performance monitor for the Verilator testbenches.
+// The testbench samples the DUT ports once per rising edge, right after evaluating the edge (inputs
+// still hold what the edge sampled, outputs show its result). Writes and reads are recognized per port,
+// reads are matched to their completion, and report() prints throughput, read latency percentiles and
+// port utilization for everything sampled since begin(). Reads still in flight at begin() are drained:
+// they complete as usual but don't count towards the new measurement.
+
+// Distribution of read latencies in cycles. Like the testbenches' READ_LATENCY constants, a latency
+// counts the edge that issued the read up to the edge after which its data is on the outputs.
+class LatencyHistogram {
+private:
+    std::vector<uint64_t> samples;
+
+public:
+    void add(uint64_t latency) { samples.push_back(latency); }
+    void clear() { samples.clear(); }
+    size_t count() const { return samples.size(); }
+
+    // Nearest-rank percentile, p in [0, 100]
+    uint64_t percentile(double p) const {
+        if (samples.empty()) return 0;
+        std::vector<uint64_t> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.999999);
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+    uint64_t min() const { return percentile(0); }
+    uint64_t max() const { return percentile(100); }
+
+    // Count of each latency value
+    std::map<uint64_t, uint64_t> buckets() const {
+        std::map<uint64_t, uint64_t> counts;
+        for (uint64_t latency : samples) counts[latency]++;
+        return counts;
+    }
+};
+
+class PerfMonitor {
+public:
+    // fixed_read_latency of ports whose reads complete when the testbench sees a valid output
+    static const int LATENCY_FROM_VALID = -1;
+
+private:
+    struct Port {
+        std::string name;
+        int bits;                       // Data bits moved per transaction
+        int fixed_read_latency;         // Reads complete this many cycles after issue, or LATENCY_FROM_VALID
+        uint64_t writes = 0;
+        uint64_t reads_issued = 0;
+        uint64_t reads_done = 0;
+        uint64_t rmw_reads = 0;         // Reads done by the DUT itself for a read-modify-write
+        uint64_t busy_cycles = 0;       // Cycles with a write or read issued
+        std::deque<uint64_t> outstanding;   // Issue cycles of reads in flight, oldest first
+        LatencyHistogram latency;       // Only kept for ports without a fixed read latency
+    };
+
+    std::string label;
+    std::vector<Port> ports;
+    uint64_t now = 0;       // Edges sampled since construction, stamps the reads in flight
+    uint64_t start = 0;     // Edge the current measurement began on
+    uint64_t cycles = 0;
+
+public:
+    // Register a port. Returns its index for sample_port().
+    int add_port(const std::string& name, int bits, int fixed_read_latency = LATENCY_FROM_VALID) {
+        Port port;
+        port.name = name;
+        port.bits = bits;
+        port.fixed_read_latency = fixed_read_latency;
+        ports.push_back(port);
+        return ports.size() - 1;
+    }
+
+    // Start a new measurement. Reads still in flight stay queued so their completions pop the right
+    // entries, but they were issued before start and aren't counted.
+    void begin(const std::string& new_label) {
+        label = new_label;
+        start = now;
+        cycles = 0;
+        for (Port& port : ports) {
+            port.writes = port.reads_issued = port.reads_done = port.rmw_reads = port.busy_cycles = 0;
+            port.latency.clear();
+        }
+    }
+
+    // Record what one port did on this edge. read_done marks the oldest read as completed (ports with a
+    // fixed read latency complete their reads by themselves, with latency 0 or 1 on the edge that issued
+    // them). rmw_read is a read the DUT issues on its own for a read-modify-write: it occupies the port but
+    // returns nothing.
+    void sample_port(int index, bool write, bool read, bool read_done = false, bool rmw_read = false) {
+        Port& port = ports[index];
+        if (write) port.writes++;
+        if (read) {
+            port.reads_issued++;
+            port.outstanding.push_back(now);
+        }
+        if (rmw_read) port.rmw_reads++;
+        if (write || read || rmw_read) port.busy_cycles++;
+
+        if (port.fixed_read_latency != LATENCY_FROM_VALID) {
+            read_done = !port.outstanding.empty() &&
+                        now - port.outstanding.front() + 1 >= (uint64_t)std::max(port.fixed_read_latency, 1);
+        }
+        if (read_done && !port.outstanding.empty()) {
+            uint64_t issued = port.outstanding.front();
+            port.outstanding.pop_front();
+            if (issued >= start) {
+                if (port.fixed_read_latency == LATENCY_FROM_VALID) port.latency.add(now - issued + 1);
+                port.reads_done++;
+            }
+        }
+    }
+
+    // Call once per edge after all ports were sampled
+    void end_cycle() {
+        now++;
+        cycles++;
+    }
+
+    void report(std::ostream& os = std::cout) const {
+        if (cycles == 0) return;
+        std::ios::fmtflags flags = os.flags();
+        os << std::fixed << std::setprecision(1);
+        os << "[perf] " << label << ": " << cycles << " cycles" << std::endl;
+        for (const Port& port : ports) {
+            uint64_t done = port.writes + port.reads_done + port.rmw_reads;
+            os << "  " << port.name << ": " << port.writes << " writes, " << port.reads_done << " reads, ";
+            if (port.rmw_reads > 0) os << port.rmw_reads << " read-modify-write reads, ";
+            os << std::setprecision(3) << (double)done / cycles << " txn/cycle ("
+               << (double)done * port.bits / cycles << " bits/cycle), " << std::setprecision(1)
+               << 100.0 * port.busy_cycles / cycles << "% utilized";
+            if (port.fixed_read_latency != LATENCY_FROM_VALID) {
+                os << ", latency " << port.fixed_read_latency << " (fixed)";
+            } else if (port.latency.count() > 0) {
+                os << ", latency min/p50/p99/max " << port.latency.min() << "/" << port.latency.percentile(50)
+                   << "/" << port.latency.percentile(99) << "/" << port.latency.max();
+                auto buckets = port.latency.buckets();
+                if (buckets.size() > 1) {
+                    os << " [";
+                    for (auto it = buckets.begin(); it != buckets.end(); ++it) {
+                        os << (it == buckets.begin() ? "" : " ") << it->first << ":" << it->second;
+                    }
+                    os << "]";
+                }
+            }
+            size_t in_flight = std::count_if(port.outstanding.begin(), port.outstanding.end(),
+                                             [this](uint64_t issued) { return issued >= start; });
+            if (in_flight > 0) os << ", " << in_flight << " reads still in flight";
+            os << std::endl;
+        }
+        os.flags(flags);
+    }
+};
+
+// circulant_barrel_shifter_v2: a write per edge with wen (plain or accumulate), a read per edge with ren,
+// reads completed in order by rTransValid. An accumulate also reads the stored row through the BRAM
+// read ports, so it counts as read port traffic too.
+class CirculantPerfMonitor : public PerfMonitor {
+private:
+    int write_port;
+    int read_port;
+
+public:
+    explicit CirculantPerfMonitor(int row_width) {
+        write_port = add_port("write", row_width);
+        read_port = add_port("read", row_width);
+    }
+
+    template<typename DUT>
+    void sample(const DUT* dut) {
+        sample_port(write_port, dut->wen, false);
+        sample_port(read_port, false, dut->ren, dut->rTransValid, dut->wen && dut->wacc);
+        end_cycle();
+    }
+};
+
+// m20k_bram_core: each port writes with wen and reads with ren (a read-during-write counts once as
+// busy), reads complete after the core's fixed read latency. Nothing is issued while in reset.
+// The latency is fixed by construction, so instead of a histogram this counts the cycles where both
+// ports hit the same address with at least one of them writing (burst reads, whose address is
+// generated inside the core, are left out).
+class M20kPerfMonitor : public PerfMonitor {
+private:
+    int port_a;
+    int port_b;
+    uint64_t collisions = 0;
+
+public:
+    M20kPerfMonitor(int data_width, int read_latency) {
+        port_a = add_port("port A", data_width, read_latency);
+        port_b = add_port("port B", data_width, read_latency);
+    }
+
+    void begin(const std::string& new_label) {
+        PerfMonitor::begin(new_label);
+        collisions = 0;
+    }
+
+    template<typename DUT>
+    void sample(const DUT* dut) {
+        bool active = !dut->rst;
+        bool access_a = active && (dut->wen_a || (dut->ren_a && !dut->burst_a));
+        bool access_b = active && (dut->wen_b || (dut->ren_b && !dut->burst_b));
+        if (access_a && access_b && dut->addr_a == dut->addr_b && (dut->wen_a || dut->wen_b)) collisions++;
+        sample_port(port_a, active && dut->wen_a, active && dut->ren_a);
+        sample_port(port_b, active && dut->wen_b, active && dut->ren_b);
+        end_cycle();
+    }
+
+    void report(std::ostream& os = std::cout) const {
+        PerfMonitor::report(os);
+        if (collisions > 0) os << "  same-address collisions: " << collisions << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef PERM_CHECKER_H
+#define PERM_CHECKER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Golden model and bank-conflict checker for the read permutations of
+// rtl/baseline/circulant_barrel_shifter_v2.v. Mirrors the bank_of/perm_src_* functions in the rtl.
+
+// Must match the PERM_* localparams in the rtl
+enum PermMode {
+    PERM_TRANSPOSE = 0,
+    PERM_BLOCK_TRANSPOSE = 1,
+    PERM_ROTATE = 2,
+    PERM_STRIDED_TRANSPOSE = 3,
+    PERM_ROW = 4,
+};
+
+const std::vector<PermMode> ALL_PERM_MODES = {
+    PERM_TRANSPOSE, PERM_BLOCK_TRANSPOSE, PERM_ROTATE, PERM_STRIDED_TRANSPOSE, PERM_ROW
+};
+
+// Must match the banking parameters the rtl was compiled with
+struct PermConfig {
+    int dim;
+    int skew_stride = 1;
+    int block_dim = 2;
+    int transpose_stride = 1;
+};
+
+inline const char* perm_name(PermMode mode) {
+    switch (mode) {
+        case PERM_TRANSPOSE: return "transpose";
+        case PERM_BLOCK_TRANSPOSE: return "block_transpose";
+        case PERM_ROTATE: return "rotate";
+        case PERM_STRIDED_TRANSPOSE: return "strided_transpose";
+        case PERM_ROW: return "row";
+    }
+    return "unknown";
+}
+
+// BRAM holding stored element (row, col)
+inline int bank_of(const PermConfig& cfg, int row, int col) {
+    return (col + cfg.skew_stride * row) % cfg.dim;
+}
+
+// Stored element (row, col) read for element j of permuted output row k
+inline std::pair<int, int> perm_source(const PermConfig& cfg, PermMode mode, int k, int j) {
+    switch (mode) {
+        case PERM_BLOCK_TRANSPOSE:
+            return {(k / cfg.block_dim) * cfg.block_dim + j % cfg.block_dim,
+                    (j / cfg.block_dim) * cfg.block_dim + k % cfg.block_dim};
+        case PERM_ROTATE:
+            return {cfg.dim - 1 - j, k};
+        case PERM_STRIDED_TRANSPOSE:
+            return {j, (k * cfg.transpose_stride) % cfg.dim};
+        case PERM_ROW:
+            return {k, j};
+        default:
+            return {j, k};
+    }
+}
+
+// Every output row must read each BRAM exactly once, otherwise it can't be produced in one cycle
+inline bool check_conflict_free(const PermConfig& cfg, PermMode mode, std::string& why) {
+    for (int k = 0; k < cfg.dim; k++) {
+        std::vector<int> owner(cfg.dim, -1);
+        for (int j = 0; j < cfg.dim; j++) {
+            auto src = perm_source(cfg, mode, k, j);
+            if (src.first < 0 || src.first >= cfg.dim || src.second < 0 || src.second >= cfg.dim) {
+                why = "row " + std::to_string(k) + " element " + std::to_string(j) + " reads outside the tile";
+                return false;
+            }
+            int bank = bank_of(cfg, src.first, src.second);
+            if (owner[bank] >= 0) {
+                why = "row " + std::to_string(k) + " reads BRAM " + std::to_string(bank) + " for elements " +
+                      std::to_string(owner[bank]) + " and " + std::to_string(j);
+                return false;
+            }
+            owner[bank] = j;
+        }
+    }
+    return true;
+}
+
+// The output rows together must contain every stored element exactly once
+inline bool check_is_permutation(const PermConfig& cfg, PermMode mode, std::string& why) {
+    std::vector<int> seen(cfg.dim * cfg.dim, 0);
+    for (int k = 0; k < cfg.dim; k++) {
+        for (int j = 0; j < cfg.dim; j++) {
+            auto src = perm_source(cfg, mode, k, j);
+            if (src.first < 0 || src.first >= cfg.dim || src.second < 0 || src.second >= cfg.dim) {
+                why = "reads outside the tile";
+                return false;
+            }
+            if (seen[src.first * cfg.dim + src.second]++) {
+                why = "element (" + std::to_string(src.first) + ", " + std::to_string(src.second) + ") read twice";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// A mode is usable if it is a permutation and conflict-free under this banking
+inline bool check_perm_mode(const PermConfig& cfg, PermMode mode, std::string& why) {
+    if (mode == PERM_BLOCK_TRANSPOSE && cfg.dim % cfg.block_dim != 0) {
+        why = "block size " + std::to_string(cfg.block_dim) + " doesn't divide " + std::to_string(cfg.dim);
+        return false;
+    }
+    return check_is_permutation(cfg, mode, why) && check_conflict_free(cfg, mode, why);
+}
+
+// Expected output rows of a permuted read
+template<typename T>
+std::vector<std::vector<T>> apply_permutation(const PermConfig& cfg, PermMode mode,
+                                              const std::vector<std::vector<T>>& matrix) {
+    std::vector<std::vector<T>> result(cfg.dim, std::vector<T>(cfg.dim));
+    for (int k = 0; k < cfg.dim; k++) {
+        for (int j = 0; j < cfg.dim; j++) {
+            auto src = perm_source(cfg, mode, k, j);
+            result[k][j] = matrix[src.first][src.second];
+        }
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef SIM_BENCHMARK_H
+#define SIM_BENCHMARK_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+
+// Simulation-speed benchmarks: a testbench runs a fixed workload with --bench, prints the result, appends
+// it to a CSV (--bench-out) and compares it with a stored baseline CSV (--bench-baseline). make bench
+// runs every configuration into results/optimized/, make bench_baseline records results/baseline/.
+//
+// CSV columns: benchmark, config, cycles, ops, seconds, cycles_per_second, cycles_per_op, peak_rss_kb.
+// Simulation speed depends on the host, so baselines are only comparable when recorded on the same one.
+
+struct BenchOptions {
+    bool enabled = false;
+    std::string out_path;           // --bench-out=path, CSV to append to
+    std::string baseline_path;      // --bench-baseline=path, CSV to compare with
+    double threshold_percent = 10;  // --bench-threshold=pct, allowed slowdown in cycles/s
+};
+
+inline BenchOptions parse_bench_args(int argc, char** argv) {
+    BenchOptions opts;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--bench") == 0) opts.enabled = true;
+        else if (std::strncmp(arg, "--bench-out=", 12) == 0) opts.out_path = arg + 12;
+        else if (std::strncmp(arg, "--bench-baseline=", 17) == 0) opts.baseline_path = arg + 17;
+        else if (std::strncmp(arg, "--bench-threshold=", 18) == 0) opts.threshold_percent = std::atof(arg + 18);
+    }
+    return opts;
+}
+
+// Peak resident set of this process so far
+inline uint64_t peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+struct BenchResult {
+    std::string benchmark;
+    std::string config;
+    uint64_t cycles = 0;
+    uint64_t ops = 0;           // Operations of the workload (accesses, tiles...)
+    double seconds = 0;
+    uint64_t rss_kb = 0;
+
+    double cycles_per_second() const { return seconds > 0 ? cycles / seconds : 0; }
+    double cycles_per_op() const { return ops > 0 ? (double)cycles / ops : 0; }
+
+    std::string csv() const {
+        std::ostringstream line;
+        line << benchmark << "," << config << "," << cycles << "," << ops << "," << std::setprecision(6)
+             << seconds << "," << std::fixed << std::setprecision(0) << cycles_per_second() << ","
+             << std::setprecision(4) << cycles_per_op() << "," << rss_kb;
+        return line.str();
+    }
+};
+
+const char* const BENCH_CSV_HEADER =
+    "benchmark,config,cycles,ops,seconds,cycles_per_second,cycles_per_op,peak_rss_kb";
+
+inline bool append_bench_csv(const std::string& path, const BenchResult& result) {
+    bool exists = std::ifstream(path).good();
+    std::ofstream file(path, std::ios::app);
+    if (!file) return false;
+    if (!exists) file << BENCH_CSV_HEADER << "\n";
+    file << result.csv() << "\n";
+    return bool(file);
+}
+
+// Baseline row for the same benchmark and config, false if there is none
+inline bool find_bench_baseline(const std::string& path, const BenchResult& result, BenchResult& baseline) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string benchmark, config, cycles, ops, seconds;
+        std::getline(fields, benchmark, ',');
+        std::getline(fields, config, ',');
+        if (benchmark != result.benchmark || config != result.config) continue;
+        std::getline(fields, cycles, ',');
+        std::getline(fields, ops, ',');
+        std::getline(fields, seconds, ',');
+        std::string skip, rss;
+        std::getline(fields, skip, ',');
+        std::getline(fields, skip, ',');
+        std::getline(fields, rss, ',');
+        baseline = BenchResult();
+        baseline.benchmark = benchmark;
+        baseline.config = config;
+        baseline.cycles = std::strtoull(cycles.c_str(), nullptr, 10);
+        baseline.ops = std::strtoull(ops.c_str(), nullptr, 10);
+        baseline.seconds = std::atof(seconds.c_str());
+        baseline.rss_kb = std::strtoull(rss.c_str(), nullptr, 10);
+        return true;
+    }
+    return false;
+}
+
+// Print the result, store it and compare it with the baseline. Returns false on a regression: cycles/s
+// down by more than the threshold, or more DUT cycles per operation than the baseline.
+inline bool report_bench(const BenchOptions& opts, const BenchResult& result) {
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "[bench] " << result.benchmark << " " << result.config << ": " << result.cycles << " cycles in "
+              << std::setprecision(3) << result.seconds << " s, " << std::setprecision(0)
+              << result.cycles_per_second() << " cycles/s, " << std::setprecision(3) << result.cycles_per_op()
+              << " cycles/op, peak RSS " << result.rss_kb << " KB" << std::defaultfloat << std::endl;
+
+    if (!opts.out_path.empty() && !append_bench_csv(opts.out_path, result)) {
+        std::cout << "[bench] can't write " << opts.out_path << std::endl;
+    }
+    if (opts.baseline_path.empty()) return true;
+
+    BenchResult baseline;
+    if (!find_bench_baseline(opts.baseline_path, result, baseline)) {
+        std::cout << "[bench] no baseline for " << result.benchmark << " " << result.config << " in "
+                  << opts.baseline_path << std::endl;
+        return true;
+    }
+    double speed_change = 100.0 * (result.cycles_per_second() / baseline.cycles_per_second() - 1);
+    bool slower = speed_change < -opts.threshold_percent;
+    bool more_cycles = result.cycles_per_op() > baseline.cycles_per_op() * 1.0001;
+    std::cout << std::fixed << std::setprecision(1) << "[bench] vs baseline: " << std::showpos << speed_change
+              << std::noshowpos << "% cycles/s, " << std::setprecision(3) << baseline.cycles_per_op() << " -> "
+              << result.cycles_per_op() << " cycles/op, peak RSS " << baseline.rss_kb << " -> " << result.rss_kb
+              << " KB" << std::defaultfloat;
+    if (slower) std::cout << "  REGRESSION: slower than the " << opts.threshold_percent << "% threshold";
+    if (more_cycles) std::cout << "  REGRESSION: more DUT cycles per operation";
+    std::cout << std::endl;
+    return !slower && !more_cycles;
+}
+
+#endif
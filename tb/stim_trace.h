@@ -0,0 +1,362 @@
+#ifndef STIM_TRACE_H
+#define STIM_TRACE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "clock_driver.h"
+
+// Compact binary stimulus traces: the DUT input ports of every cycle, recorded from a testbench run (or
+// converted from a captured access stream) and replayed through ClockDriver::run() at full speed.
+//
+// A trace has a fixed list of named fields, one per port (up to 64 bits each). The last num_outputs
+// fields are output ports captured after each edge, which a replay can compare against. Besides clocked
+// cycles a trace can hold unclocked rows: changes the testbench made without a clock edge (backdoor
+// writes), which a replay hands back to the testbench in order. File layout, little-endian:
+//   "TBTRACE2", u32 field count, u32 output field count, u64 cycle count (clocked rows),
+//   per field: u8 name length, name
+//   records until the end of the file
+// A record is one row in which some field changed, preceded by a run of cycles that repeat the previous
+// values: varint run length, a bitmask of the changed fields (one bit per field, plus a last bit set for
+// an unclocked row, rounded up to bytes), then for each changed field the zigzag varint of (new - old).
+// Fields start at zero. Idle cycles thus cost nothing beyond their run length, and incrementing
+// addresses a byte or two. "TBTRACE1" traces (no outputs, no unclocked rows, no flag bit) still read.
+//
+// Replay memory-maps the file and decodes it in batches, releasing the pages behind the read position
+// as it goes, so multi-GB traces stream without being loaded.
+
+class TraceWriter {
+private:
+    FILE* file = nullptr;
+    std::vector<uint64_t> prev;
+    std::vector<uint8_t> buffer;
+    uint64_t cycles = 0;
+    uint64_t pending_repeats = 0;   // Cycles since the last record that repeated its values
+    bool first = true;
+
+    void put_varint(uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(uint8_t(value) | 0x80);
+            value >>= 7;
+        }
+        buffer.push_back(uint8_t(value));
+    }
+
+    void put_record(const uint64_t* values, bool unclocked) {
+        put_varint(pending_repeats);
+        pending_repeats = 0;
+        size_t mask_pos = buffer.size();
+        buffer.resize(buffer.size() + (prev.size() + 8) / 8, 0);
+        if (unclocked) buffer[mask_pos + prev.size() / 8] |= 1 << (prev.size() % 8);
+        for (size_t field = 0; field < prev.size(); field++) {
+            if (values[field] == prev[field]) continue;
+            buffer[mask_pos + field / 8] |= 1 << (field % 8);
+            int64_t delta = int64_t(values[field] - prev[field]);
+            put_varint((uint64_t(delta) << 1) ^ uint64_t(delta >> 63));
+            prev[field] = values[field];
+        }
+        if (buffer.size() >= (1 << 20)) flush();
+    }
+
+    void flush() {
+        if (!buffer.empty()) fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+
+public:
+    ~TraceWriter() { close(); }
+
+    // The last num_outputs of field_names are outputs
+    bool open(const std::string& path, const std::vector<std::string>& field_names, uint32_t num_outputs = 0) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        prev.assign(field_names.size(), 0);
+        cycles = pending_repeats = 0;
+        first = true;
+        uint32_t header[2] = {uint32_t(field_names.size()), num_outputs};
+        fwrite("TBTRACE2", 1, 8, file);
+        fwrite(header, sizeof(header), 1, file);
+        fwrite(&cycles, sizeof(cycles), 1, file);
+        for (const std::string& name : field_names) {
+            uint8_t len = name.size();
+            fwrite(&len, 1, 1, file);
+            fwrite(name.data(), 1, len, file);
+        }
+        return true;
+    }
+
+    bool is_open() const { return file != nullptr; }
+
+    // Add one cycle, values[i] for field i
+    void record(const uint64_t* values) {
+        cycles++;
+        if (!first && std::memcmp(values, prev.data(), prev.size() * sizeof(uint64_t)) == 0) {
+            pending_repeats++;
+            return;
+        }
+        first = false;
+        put_record(values, false);
+    }
+
+    // Add a row applied without a clock edge (e.g. a backdoor write), between the cycles recorded
+    // before and after it
+    void record_unclocked(const uint64_t* values) {
+        first = false;
+        put_record(values, true);
+    }
+
+    // Flush, write the cycle count into the header and close. Returns the file size in bytes.
+    uint64_t close() {
+        if (!file) return 0;
+        if (pending_repeats > 0) {
+            // Trailing idle cycles: the last of them becomes a record without changes
+            pending_repeats--;
+            put_record(prev.data(), false);
+        }
+        flush();
+        uint64_t size = ftell(file);
+        fseek(file, 16, SEEK_SET);
+        fwrite(&cycles, sizeof(cycles), 1, file);
+        fclose(file);
+        file = nullptr;
+        return size;
+    }
+};
+
+class TraceReader {
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t pos = 0;
+    size_t released = 0;            // Pages before this offset were handed back to the kernel
+    std::vector<std::string> names;
+    uint32_t outputs = 0;
+    bool flag_bit = false;          // Records carry the unclocked flag (TBTRACE2)
+    std::vector<uint64_t> current, staged;
+    uint64_t total_cycles = 0;
+    uint64_t cycles_read = 0;
+    uint64_t repeats = 0;           // Cycles of the current values still to emit before staged
+    bool have_staged = false;
+    bool staged_clocked = true;
+
+    static const size_t RELEASE_CHUNK = 64 << 20;
+
+    uint64_t get_varint() {
+        uint64_t value = 0;
+        int shift = 0;
+        while (pos < size) {
+            uint8_t byte = data[pos++];
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+        return value;
+    }
+
+    // Stage the next record. Returns false at the end of the file.
+    bool decode_record() {
+        if (pos >= size) return false;
+        repeats = get_varint();
+        staged = current;
+        size_t mask_pos = pos;
+        size_t mask_bits = names.size() + (flag_bit ? 1 : 0);
+        pos += (mask_bits + 7) / 8;
+        staged_clocked = !(flag_bit && (data[mask_pos + names.size() / 8] & (1 << (names.size() % 8))));
+        for (size_t field = 0; field < names.size(); field++) {
+            if (!(data[mask_pos + field / 8] & (1 << (field % 8)))) continue;
+            uint64_t zigzag = get_varint();
+            staged[field] += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        }
+        have_staged = true;
+        if (pos - released >= RELEASE_CHUNK) {
+            size_t page = sysconf(_SC_PAGESIZE);
+            size_t upto = (pos / page) * page;
+            madvise((void*)(data + released), upto - released, MADV_DONTNEED);
+            released = upto;
+        }
+        return true;
+    }
+
+public:
+    ~TraceReader() { close(); }
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 24) {
+            ::close(fd);
+            return false;
+        }
+        size = st.st_size;
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) return false;
+        data = (const uint8_t*)map;
+        madvise(map, size, MADV_SEQUENTIAL);
+
+        uint32_t num_fields;
+        if (std::memcmp(data, "TBTRACE2", 8) == 0) {
+            flag_bit = true;
+            std::memcpy(&outputs, data + 12, sizeof(outputs));
+        } else if (std::memcmp(data, "TBTRACE1", 8) == 0) {
+            flag_bit = false;
+            outputs = 0;
+        } else {
+            close();
+            return false;
+        }
+        std::memcpy(&num_fields, data + 8, sizeof(num_fields));
+        std::memcpy(&total_cycles, data + 16, sizeof(total_cycles));
+        pos = 24;
+        names.clear();
+        for (uint32_t i = 0; i < num_fields && pos < size; i++) {
+            uint8_t len = data[pos++];
+            names.emplace_back((const char*)data + pos, len);
+            pos += len;
+        }
+        current.assign(num_fields, 0);
+        cycles_read = repeats = released = 0;
+        have_staged = false;
+        return names.size() == num_fields && outputs <= num_fields;
+    }
+
+    void close() {
+        if (data) munmap((void*)data, size);
+        data = nullptr;
+    }
+
+    const std::vector<std::string>& field_names() const { return names; }
+    size_t num_fields() const { return names.size(); }
+    size_t num_outputs() const { return outputs; }
+    uint64_t cycles() const { return total_cycles; }
+    uint64_t file_size() const { return size; }
+
+    // Next cycle into values[0..num_fields). Returns false at the end of the trace, or when the next row
+    // is an unclocked one (see next_unclocked()).
+    bool next(uint64_t* values) {
+        if (!have_staged && !decode_record()) return false;
+        if (repeats > 0) {
+            repeats--;
+        } else {
+            if (!staged_clocked) return false;
+            current.swap(staged);
+            have_staged = false;
+        }
+        std::memcpy(values, current.data(), current.size() * sizeof(uint64_t));
+        cycles_read++;
+        return true;
+    }
+
+    // The next row if it is an unclocked one, otherwise returns false
+    bool next_unclocked(uint64_t* values) {
+        if (!have_staged && !decode_record()) return false;
+        if (repeats > 0 || staged_clocked) return false;
+        current.swap(staged);
+        have_staged = false;
+        std::memcpy(values, current.data(), current.size() * sizeof(uint64_t));
+        return true;
+    }
+
+    // Up to max_cycles cycles, row after row of num_fields values, stopping before an unclocked row.
+    // Returns the number of cycles.
+    size_t next_batch(uint64_t* values, size_t max_cycles) {
+        size_t n = 0;
+        while (n < max_cycles && next(values + n * names.size())) n++;
+        return n;
+    }
+};
+
+// Replay a whole trace through clock.run() in batches. apply(dut, const uint64_t* fields) drives one
+// cycle's fields, capture(dut, Out&) records its outputs, sink(const uint64_t* fields, const Out*, n)
+// consumes each batch of them along with the batch's rows (num_fields values each), and
+// unclocked(const uint64_t* fields) applies each unclocked row. Returns the cycles replayed.
+template<typename Out, typename DUT, typename Apply, typename Capture, typename Sink, typename Unclocked>
+uint64_t replay_trace(ClockDriver<DUT>& clock, TraceReader& trace, Apply apply, Capture capture, Sink sink,
+                      Unclocked unclocked) {
+    const size_t batch = 4096;
+    std::vector<uint64_t> values(batch * trace.num_fields());
+    std::vector<const uint64_t*> rows(batch);
+    std::vector<Out> outputs(batch);
+    for (size_t i = 0; i < batch; i++) rows[i] = &values[i * trace.num_fields()];
+
+    uint64_t total = 0;
+    for (;;) {
+        size_t n = trace.next_batch(values.data(), batch);
+        if (n > 0) {
+            clock.run(n, rows.data(), outputs.data(), apply, capture);
+            sink((const uint64_t*)values.data(), (const Out*)outputs.data(), n);
+            total += n;
+        } else if (trace.next_unclocked(values.data())) {
+            unclocked((const uint64_t*)values.data());
+        } else {
+            break;
+        }
+    }
+    return total;
+}
+
+// Stimulus only, for benchmarking. Unclocked rows are skipped.
+template<typename DUT, typename Apply>
+uint64_t replay_trace(ClockDriver<DUT>& clock, TraceReader& trace, Apply apply) {
+    return replay_trace<char>(clock, trace, apply, [](DUT*, char&) {}, [](const uint64_t*, const char*, size_t) {},
+                              [](const uint64_t*) {});
+}
+
+struct TraceReplayResult {
+    uint64_t cycles = 0;
+    uint64_t mismatches = 0;        // Cycles whose outputs differ from the recorded ones
+    uint64_t first_mismatch = 0;    // Clocked cycle of the first of them
+};
+
+// Replay a trace and compare the outputs after every edge with the ones it recorded.
+// get_outputs(dut, uint64_t* outs) reads the DUT's outputs in the order of the trace's output fields.
+const size_t MAX_TRACE_OUTPUTS = 8;
+
+template<typename DUT, typename Apply, typename GetOutputs, typename Unclocked>
+TraceReplayResult replay_trace_checked(ClockDriver<DUT>& clock, TraceReader& trace, Apply apply,
+                                       GetOutputs get_outputs, Unclocked unclocked) {
+    struct Outputs {
+        uint64_t values[MAX_TRACE_OUTPUTS];
+    };
+    TraceReplayResult result;
+    size_t num_fields = trace.num_fields();
+    size_t num_outputs = std::min(trace.num_outputs(), MAX_TRACE_OUTPUTS);
+    size_t first_output = num_fields - trace.num_outputs();
+    uint64_t checked = 0;
+    result.cycles = replay_trace<Outputs>(clock, trace, apply,
+        [&](DUT* dut, Outputs& out) { get_outputs(dut, out.values); },
+        [&](const uint64_t* fields, const Outputs* outs, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                const uint64_t* recorded = fields + i * num_fields + first_output;
+                if (std::memcmp(outs[i].values, recorded, num_outputs * sizeof(uint64_t)) == 0) continue;
+                if (result.mismatches++ == 0) result.first_mismatch = checked + i;
+            }
+            checked += n;
+        },
+        unclocked);
+    return result;
+}
+
+struct TraceOptions {
+    std::string record_path;    // --record-trace=path: record the stimulus of the test run
+    std::string replay_path;    // --replay-trace=path: replay a trace instead of running the tests
+};
+
+inline TraceOptions parse_trace_args(int argc, char** argv) {
+    TraceOptions opts;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--record-trace=", 15) == 0) opts.record_path = argv[i] + 15;
+        else if (std::strncmp(argv[i], "--replay-trace=", 15) == 0) opts.replay_path = argv[i] + 15;
+    }
+    return opts;
+}
+
+#endif
@@ -5,14 +5,44 @@
 #include <random>
 #include <map>
 #include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <memory>
 #include <verilated.h>
 #include "Vm20k_bram_core.h"
+#include "backdoor.h"
+#include "checkpoint.h"
+#include "clock_driver.h"
+#include "parallel_regression.h"
+#include "perf_monitor.h"
+#include "sim_benchmark.h"
+#include "stim_trace.h"
 
 // TODO: use 64 bit types instead of 32 bit to enable testing 40 bit logical width
 
-// Change these when compiling the rtl with differnt logical widths
+// Change these when compiling the rtl with differnt logical widths (make sets them from LOG_WIDTH/DEPTH)
+#ifdef TB_LOG_WIDTH
+const int LOG_WIDTH = TB_LOG_WIDTH;
+#else
 const int LOG_WIDTH = 4; 
+#endif
+#ifdef TB_LOG_DEPTH
+const int LOG_DEPTH = TB_LOG_DEPTH;
+#else
 const int LOG_DEPTH = 4096; 
+#endif
+// Registers the rtl was compiled with, set by make from M20K_REG_INPUTS/M20K_REG_OUTPUTS
+#ifdef TB_REG_INPUTS
+const int REG_INPUTS = TB_REG_INPUTS;
+#else
+const int REG_INPUTS = 1;
+#endif
+#ifdef TB_REG_OUTPUTS
+const int REG_OUTPUTS = TB_REG_OUTPUTS;
+#else
+const int REG_OUTPUTS = 1;
+#endif
+const int READ_LATENCY = REG_INPUTS + REG_OUTPUTS;
 
 class M20kTester {
 private:
@@ -20,6 +50,8 @@ private:
     vluint64_t sim_time;
     static const int PHYS_WIDTH = 160;
     static const int PHYS_DEPTH = 128;
+    static const int BYTE_LANE_WIDTH = 8;
+    static const int COL_MUX_FACTOR = 4;
     
     // Test configuration tracking
     int log_width;
@@ -30,13 +62,30 @@ private:
     
     // Reference memory for verification
     std::map<uint32_t, uint32_t> ref_memory;
+
+    M20kPerfMonitor perf;   // Sees every edge, reported per test
+    ClockDriver<Vm20k_bram_core> clock;
+    TraceWriter recorder;   // Records every cycle of tick() and run(), and the backdoor preloads, while open
+    std::string record_path;
     
 public:
-    M20kTester(int width = 8, int depth = 2048) : 
-        sim_time(0), log_width(width), log_depth(depth), 
-        test_count(0), pass_count(0), fail_count(0) {
+    M20kTester(int width = 8, int depth = 2048, const std::string& record_path = "") : 
+        dut(new Vm20k_bram_core()), sim_time(0), log_width(width), log_depth(depth), 
+        test_count(0), pass_count(0), fail_count(0), perf(width, READ_LATENCY), clock(dut),
+        record_path(record_path) {
             
-        dut = new Vm20k_bram_core();
+        clock.on_edge = [this] { perf.sample(dut); };
+        if (!record_path.empty()) {
+            if (recorder.open(record_path, trace_field_names(), NUM_TRACE_OUTPUTS)) {
+                clock.on_cycle = [this] {
+                    uint64_t fields[NUM_TRACE_FIELDS];
+                    get_trace_fields(dut, fields);
+                    recorder.record(fields);
+                };
+            } else {
+                std::cout << "Can't open " << record_path << " to record the stimulus" << std::endl;
+            }
+        }
         reset_ports();
         std::cout << "=== M20K BRAM Tester Initialized ===" << std::endl;
         std::cout << "Configuration: " << log_width << "x" << log_depth << std::endl;
@@ -44,6 +93,10 @@ public:
     }
 
     ~M20kTester() {
+        if (recorder.is_open()) {
+            uint64_t bytes = recorder.close();
+            std::cout << "Recorded the stimulus to " << record_path << " (" << bytes << " bytes)" << std::endl;
+        }
         delete dut;
         print_summary();
     }
@@ -53,21 +106,37 @@ public:
         dut->rst = 0;
         dut->addr_a = 0;
         dut->data_in_a = 0;
+        dut->be_a = all_lanes();
         dut->wen_a = 0;
         dut->ren_a = 0;
+        dut->burst_a = 0;
         dut->addr_b = 0;
         dut->data_in_b = 0;
+        dut->be_b = all_lanes();
         dut->wen_b = 0;
         dut->ren_b = 0;
+        dut->burst_b = 0;
+    }
+
+    int num_lanes() {
+        return (log_width + BYTE_LANE_WIDTH - 1) / BYTE_LANE_WIDTH;
+    }
+
+    uint32_t all_lanes() {
+        return (1u << num_lanes()) - 1;
+    }
+
+    // Data bits covered by a byte enable mask
+    uint32_t lane_mask(uint32_t be) {
+        uint32_t mask = 0;
+        for (int lane = 0; lane < num_lanes(); lane++) {
+            if (be & (1u << lane)) mask |= ((1u << BYTE_LANE_WIDTH) - 1) << (lane * BYTE_LANE_WIDTH);
+        }
+        return mask & ((1u << log_width) - 1);
     }
 
     void tick() {
-        dut->clk = 0;
-        dut->eval();
-        dut->clk = 1;
-        dut->eval();
-        dut->clk = 0;
-        dut->eval();
+        clock.tick();
         sim_time++;
     }
 
@@ -394,7 +463,686 @@ public:
                    "wrote=0x" + to_hex(data_b) + ", read=0x" + to_hex(final_read));
     }
 
+    // Test 7: Activity Counters (energy model inputs)
+    void test_activity_counters() {
+        std::cout << "\n--- Test 7: Activity Counters ---" << std::endl;
+        dut_reset();
+
+        assert_test(dut->wl_activations == 0 && dut->bitlines_sensed == 0 && dut->cells_written == 0,
+                   "Counters cleared by reset");
+
+        // One write: one wordline, log_width cells
+        write_port_a(5, 0x3);
+        tick(1);
+        assert_test(dut->wl_activations == 1 && dut->cells_written == (uint32_t)log_width,
+                   "Single write activity",
+                   "wl=" + std::to_string(dut->wl_activations) + ", written=" + std::to_string(dut->cells_written));
+
+        // One read: one wordline, log_width bitlines sensed
+        dut->addr_a = 5;
+        dut->ren_a = 1;
+        tick(1);
+        dut->ren_a = 0;
+        tick(1);
+        assert_test(dut->wl_activations == 2 && dut->bitlines_sensed == (uint32_t)log_width,
+                   "Single read activity",
+                   "wl=" + std::to_string(dut->wl_activations) + ", sensed=" + std::to_string(dut->bitlines_sensed));
+
+        // Both ports in the same cycle activate two wordlines
+        dut->addr_a = 5;
+        dut->ren_a = 1;
+        dut->addr_b = 200;
+        dut->data_in_b = 0x1;
+        dut->wen_b = 1;
+        tick(1);
+        dut->ren_a = 0;
+        dut->wen_b = 0;
+        tick(1);
+        assert_test(dut->wl_activations == 4 &&
+                    dut->bitlines_sensed == (uint32_t)(2 * log_width) &&
+                    dut->cells_written == (uint32_t)(2 * log_width),
+                   "Dual port activity",
+                   "wl=" + std::to_string(dut->wl_activations));
+    }
+
+    // Test 8: Column-Muxed Row Layout
+    // All logical words of one physical row share sense amps when interleaved, so fill a full row
+    // with distinct values and check no word overwrites its neighbours
+    void test_row_interleave() {
+        std::cout << "\n--- Test 8: Column-Muxed Row Layout ---" << std::endl;
+        dut_reset();
+
+        int words_per_row = PHYS_WIDTH / log_width;
+        uint32_t data_mask = (1 << log_width) - 1;
+        uint32_t base_addr = words_per_row; // Second physical row
+
+        for (int word = 0; word < words_per_row; word++) {
+            write_port_a(base_addr + word, (0x5A ^ (word * 0x11)) & data_mask);
+        }
+        tick(1);
+
+        bool all_match = true;
+        for (int word = 0; word < words_per_row; word++) {
+            uint32_t expected = (0x5A ^ (word * 0x11)) & data_mask;
+            uint32_t read_data = read_port_a(base_addr + word);
+            if (read_data != expected) {
+                all_match = false;
+                std::cout << "Word " << word << ": expected=0x" << to_hex(expected)
+                          << ", read=0x" << to_hex(read_data) << std::endl;
+            }
+        }
+        assert_test(all_match, "Full physical row of interleaved words",
+                   std::to_string(words_per_row) + " words per row");
+
+        // Check where the bits landed. With the mux interleave, bit b of word w sits under sense amp b of
+        // its group of COL_MUX_FACTOR words, at mux position w % COL_MUX_FACTOR. Widths whose words per row
+        // aren't a multiple of the mux factor (x16, x32) pack words contiguously instead.
+        int interleave = (words_per_row % COL_MUX_FACTOR == 0) ? COL_MUX_FACTOR : 1;
+        std::vector<uint8_t> cells = m20k_backdoor_dump_row(dut, 1, PHYS_WIDTH);
+        bool placed = cells.size() == (size_t)PHYS_WIDTH;
+        for (int word = 0; word < words_per_row && placed; word++) {
+            uint32_t data = (0x5A ^ (word * 0x11)) & data_mask;
+            for (int bit = 0; bit < log_width; bit++) {
+                int col = (word / interleave) * (log_width * interleave) + bit * interleave + word % interleave;
+                if (cells[col] != ((data >> bit) & 1)) {
+                    placed = false;
+                    std::cout << "Word " << word << " bit " << bit << ": expected column " << col
+                              << " to hold " << ((data >> bit) & 1) << std::endl;
+                    break;
+                }
+            }
+        }
+        assert_test(placed, "Physical cell placement",
+                    interleave > 1 ? "bits " + std::to_string(interleave) + " columns apart" : "contiguous words");
+    }
+
+    // Test 9: Burst Reads From the Row Buffer
+    void test_burst_read() {
+        std::cout << "\n--- Test 9: Burst Reads ---" << std::endl;
+        dut_reset();
+
+        int words_per_row = PHYS_WIDTH / log_width;
+        int num_rows = 3;
+        int num_words = words_per_row * num_rows;
+        uint32_t data_mask = (1 << log_width) - 1;
+        uint32_t base_addr = 2 * words_per_row; // Start on a physical row boundary
+
+        for (int word = 0; word < num_words; word++) {
+            write_port_a(base_addr + word, (word * 7 + 3) & data_mask);
+        }
+        tick(1);
+
+        // Single-word reads activate a wordline for every word
+        uint32_t wl_start = dut->wl_activations;
+        for (int word = 0; word < num_words; word++) {
+            read_port_a(base_addr + word);
+        }
+        uint32_t single_activations = dut->wl_activations - wl_start;
+
+        // Burst: hold ren_a/burst_a for num_words cycles, one word comes out per cycle
+        wl_start = dut->wl_activations;
+        uint32_t burst_start_cycle = sim_time;
+        std::vector<uint32_t> burst_data;
+        dut->addr_a = base_addr;
+        dut->ren_a = 1;
+        dut->burst_a = 1;
+        for (int cycle = 0; cycle <= num_words; cycle++) {
+            if (cycle == num_words) {
+                dut->ren_a = 0;
+                dut->burst_a = 0;
+            }
+            tick(1);
+            if (cycle >= 1) burst_data.push_back(dut->data_out_a & data_mask);
+        }
+        tick(1);
+        uint32_t burst_cycles = sim_time - burst_start_cycle;
+        uint32_t burst_activations = dut->wl_activations - wl_start;
+
+        bool all_match = true;
+        for (int word = 0; word < num_words; word++) {
+            uint32_t expected = (word * 7 + 3) & data_mask;
+            if (burst_data[word] != expected) {
+                all_match = false;
+                std::cout << "Burst word " << word << ": expected=0x" << to_hex(expected)
+                          << ", read=0x" << to_hex(burst_data[word]) << std::endl;
+            }
+        }
+        assert_test(all_match, "Burst read data", std::to_string(num_words) + " sequential words");
+        assert_test(burst_activations == (uint32_t)num_rows, "Burst wordline activations",
+                   "burst=" + std::to_string(burst_activations) + ", single reads=" + std::to_string(single_activations) +
+                   ", saved=" + std::to_string(single_activations - burst_activations));
+        std::cout << "Burst read " << num_words << " words in " << burst_cycles << " cycles ("
+                  << std::fixed << std::setprecision(2) << (double)num_words / burst_cycles
+                  << " words/cycle vs " << 0.5 << " for single reads)" << std::defaultfloat << std::endl;
+
+        // A write to the buffered row must not be hidden by a stale row buffer
+        dut->addr_a = base_addr;
+        dut->ren_a = 1;
+        dut->burst_a = 1;
+        tick(2);
+        dut->ren_a = 0;
+        dut->burst_a = 0;
+        write_port_b(base_addr + 2, 0x5 & data_mask);
+        dut->addr_a = base_addr + 2;
+        dut->ren_a = 1;
+        dut->burst_a = 1;
+        tick(2);
+        dut->ren_a = 0;
+        dut->burst_a = 0;
+        uint32_t after_write = dut->data_out_a & data_mask;
+        assert_test(after_write == (0x5 & data_mask), "Row buffer invalidated by write",
+                   "read=0x" + to_hex(after_write));
+    }
+
+    // Test 10: Byte Enables for Partial-Word Writes
+    void test_byte_enables() {
+        std::cout << "\n--- Test 10: Byte Enables ---" << std::endl;
+        dut_reset();
+
+        uint32_t data_mask = (1 << log_width) - 1;
+        uint32_t addr = 300;
+        uint32_t initial = 0xA5A5A5A5 & data_mask;
+        uint32_t update = 0x3C3C3C3C & data_mask;
+
+        // No lanes enabled: the write must not change anything
+        write_port_a(addr, initial);
+        dut->be_a = 0;
+        write_port_a(addr, update);
+        dut->be_a = all_lanes();
+        tick(1);
+        uint32_t read_data = read_port_a(addr);
+        assert_test(read_data == initial, "Write with no lanes enabled",
+                   "read=0x" + to_hex(read_data));
+
+        // Update only the lowest lane, through port B this time
+        uint32_t wl_start = dut->wl_activations;
+        uint64_t start_cycle = sim_time;
+        dut->be_b = 1;
+        dut->addr_b = addr;
+        dut->data_in_b = update;
+        dut->wen_b = 1;
+        tick(1);
+        dut->wen_b = 0;
+        dut->be_b = all_lanes();
+        uint64_t be_cycles = sim_time - start_cycle;
+        tick(1);
+        uint32_t be_activations = dut->wl_activations - wl_start;
+
+        uint32_t expected = (initial & ~lane_mask(1)) | (update & lane_mask(1));
+        read_data = read_port_b(addr);
+        assert_test(read_data == expected, "Single lane write",
+                   "expected=0x" + to_hex(expected) + ", read=0x" + to_hex(read_data));
+
+        // The same update done as a read-modify-write without byte enables
+        write_port_a(addr, initial);
+        tick(1);
+        wl_start = dut->wl_activations;
+        start_cycle = sim_time;
+        uint32_t old_data = read_port_a(addr);
+        write_port_a(addr, (old_data & ~lane_mask(1)) | (update & lane_mask(1)));
+        uint64_t rmw_cycles = sim_time - start_cycle;
+        tick(1);
+        uint32_t rmw_activations = dut->wl_activations - wl_start;
+
+        read_data = read_port_a(addr);
+        assert_test(read_data == expected, "Read-modify-write reference",
+                   "expected=0x" + to_hex(expected) + ", read=0x" + to_hex(read_data));
+        std::cout << "Lane update: byte enable = " << be_cycles << " port cycle(s), " << be_activations
+                  << " activation(s); read-modify-write = " << rmw_cycles << " port cycles, "
+                  << rmw_activations << " activations" << std::endl;
+    }
+
+    // Test 11: Read Latency of the Configured Registers
+    void test_read_latency() {
+        std::cout << "\n--- Test 11: Read Latency (REG_INPUTS=" << REG_INPUTS
+                  << ", REG_OUTPUTS=" << REG_OUTPUTS << ") ---" << std::endl;
+        dut_reset();
+
+        uint32_t data_mask = (1 << log_width) - 1;
+        std::vector<uint32_t> addrs = {10, 11, 12, 13, 14, 15};
+        for (uint32_t addr : addrs) write_port_a(addr, (addr * 0x9) ^ 0xA);
+        tick(1);
+        read_port_a(0);
+
+        // Single read of a word that differs from what the port shows now: the port must keep the old word
+        // until exactly READ_LATENCY edges after the read was issued, then show the new one
+        dut->eval();
+        uint32_t before = dut->data_out_a & data_mask;
+        uint32_t expected = ~before & data_mask;
+        write_port_a(addrs[0], expected);
+        tick(1);
+        dut->addr_a = addrs[0];
+        dut->ren_a = 1;
+        dut->eval();
+        int arrival = -1;
+        for (int cycles = 0; cycles <= READ_LATENCY + 2 && arrival < 0; cycles++) {
+            if (cycles > 0) {
+                tick(1);
+                dut->ren_a = 0;
+            }
+            uint32_t data = dut->data_out_a & data_mask;
+            if (data == expected) arrival = cycles;
+            else if (data != before) break;
+        }
+        dut->ren_a = 0;
+        assert_test(arrival == READ_LATENCY, "Single read latency",
+                   "measured=" + std::to_string(arrival) + ", expected=" + std::to_string(READ_LATENCY));
+        tick(2);
+
+        // One read per cycle: read i is on the port READ_LATENCY edges after it was issued
+        std::vector<uint32_t> results;
+        for (size_t cycle = 0; cycle < addrs.size() + READ_LATENCY; cycle++) {
+            if (cycle < addrs.size()) {
+                dut->addr_a = addrs[cycle];
+                dut->ren_a = 1;
+            } else {
+                dut->ren_a = 0;
+            }
+            dut->eval();
+            if (cycle >= (size_t)READ_LATENCY) results.push_back(dut->data_out_a & data_mask);
+            tick(1);
+        }
+        dut->ren_a = 0;
+
+        bool all_match = results.size() == addrs.size();
+        for (size_t i = 0; i < results.size(); i++) {
+            if (results[i] != ref_memory[addrs[i]]) all_match = false;
+        }
+        assert_test(all_match, "Back-to-back reads at latency " + std::to_string(READ_LATENCY));
+    }
+
+    // Inputs of one cycle and the outputs after its edge, for ClockDriver::run()
+    struct CycleStim {
+        uint8_t wen_a;
+        uint8_t ren_b;
+        uint32_t addr_a;
+        uint32_t addr_b;
+        uint32_t data_in_a;
+    };
+
+    static void apply_stim(Vm20k_bram_core* d, const CycleStim& s) {
+        d->wen_a = s.wen_a;
+        d->addr_a = s.addr_a;
+        d->data_in_a = s.data_in_a;
+        d->ren_b = s.ren_b;
+        d->addr_b = s.addr_b;
+    }
+
+    static void capture_out(Vm20k_bram_core* d, uint32_t& data_out_b) {
+        data_out_b = d->data_out_b;
+    }
+
+    // Test 12: Simulation speed. Passes that fill the memory on port A then read it all back on port B,
+    // driven three ways: the original three-eval tick without hooks (the reference), one cycle at a
+    // time through tick() (with the perf monitor and trace hooks), and preloaded into ClockDriver::run().
+    void test_sim_speed() {
+        std::cout << "\n--- Test 12: Simulation Speed ---" << std::endl;
+        dut_reset();
+        reset_ports();
+
+        uint32_t data_mask = (1 << log_width) - 1;
+        const int passes = 50;
+        std::vector<CycleStim> stimulus;
+        std::vector<uint32_t> expected;   // Data of each read, in issue order
+        for (int pass = 0; pass < passes; pass++) {
+            for (int addr = 0; addr < log_depth; addr++) {
+                stimulus.push_back({1, 0, (uint32_t)addr, 0, (uint32_t)(addr * 0x9E37 + pass * 0x55) & data_mask});
+            }
+            for (int addr = 0; addr < log_depth; addr++) {
+                stimulus.push_back({0, 1, 0, (uint32_t)addr, 0});
+                expected.push_back((addr * 0x9E37 + pass * 0x55) & data_mask);
+            }
+        }
+        for (int i = 0; i < READ_LATENCY; i++) stimulus.push_back({0, 0, 0, 0, 0});
+
+        // Reference: clk=0, clk=1 and clk=0 evals per cycle, as the testbench clocked the DUT before
+        std::vector<uint32_t> reference(stimulus.size());
+        double reference_rate = measure_cycles_per_second(stimulus.size(), [&] {
+            for (size_t i = 0; i < stimulus.size(); i++) {
+                dut->wen_a = stimulus[i].wen_a;
+                dut->addr_a = stimulus[i].addr_a;
+                dut->data_in_a = stimulus[i].data_in_a;
+                dut->ren_b = stimulus[i].ren_b;
+                dut->addr_b = stimulus[i].addr_b;
+                dut->clk = 0;
+                dut->eval();
+                dut->clk = 1;
+                dut->eval();
+                if (clock.on_cycle) clock.on_cycle();   // Only set while recording a trace
+                dut->clk = 0;
+                dut->eval();
+                reference[i] = dut->data_out_b;
+            }
+        });
+        sim_time += stimulus.size();
+
+        dut_reset();
+        std::vector<uint32_t> stepwise(stimulus.size());
+        double stepwise_rate = measure_cycles_per_second(stimulus.size(), [&] {
+            for (size_t i = 0; i < stimulus.size(); i++) {
+                dut->wen_a = stimulus[i].wen_a;
+                dut->addr_a = stimulus[i].addr_a;
+                dut->data_in_a = stimulus[i].data_in_a;
+                dut->ren_b = stimulus[i].ren_b;
+                dut->addr_b = stimulus[i].addr_b;
+                tick();
+                stepwise[i] = dut->data_out_b;
+            }
+        });
+
+        // Same starting state (output register cleared) for the batched run
+        dut_reset();
+        std::vector<uint32_t> batched;
+        double batched_rate = measure_cycles_per_second(stimulus.size(), [&] {
+            clock.run(stimulus, batched, apply_stim, capture_out);
+        });
+        sim_time += stimulus.size();
+        reset_ports();
+
+        // The read issued in cycle i is on the port after the edge of cycle i + READ_LATENCY - 1
+        bool match = batched == stepwise && batched == reference;
+        size_t read_idx = 0;
+        for (size_t i = 0; i < stimulus.size(); i++) {
+            if (!stimulus[i].ren_b) continue;
+            if ((batched[i + READ_LATENCY - 1] & data_mask) != expected[read_idx++]) match = false;
+        }
+
+        report_sim_speed(reference_rate, stepwise_rate, batched_rate);
+        assert_test(match, "Batched run matches stepwise and reference over " + std::to_string(stimulus.size()) + " cycles");
+    }
+
+    // Test 13: Checkpoint/restore. The reset and a write to every address are done once and saved,
+    // then each scenario starts from the restored snapshot instead of redoing them.
+    void test_checkpoint_restore() {
+        std::cout << "\n--- Test 13: Checkpoint/Restore ---" << std::endl;
+        if (!CHECKPOINTS_AVAILABLE) {
+            std::cout << "Skipped, build with SAVABLE=1 (Verilator --savable) to enable checkpoints" << std::endl;
+            return;
+        }
+        if (recorder.is_open()) {
+            std::cout << "Skipped while recording a trace, a restore can't be replayed" << std::endl;
+            return;
+        }
+        const std::string path = "m20k_prepared.ckpt";
+        typedef std::chrono::steady_clock Clock;
+
+        // Warm-up: reset and fill the whole memory through port A
+        auto warm_start = Clock::now();
+        uint64_t warm_start_cycle = sim_time;
+        dut_reset();
+        reset_ports();
+        for (int addr = 0; addr < log_depth; addr++) {
+            write_port_a(addr, addr * 0x3B + 0x11);
+        }
+        tick(READ_LATENCY);
+        uint64_t warm_cycles = sim_time - warm_start_cycle;
+        std::chrono::duration<double> warm_time = Clock::now() - warm_start;
+
+        bool saved = save_checkpoint(path, dut, sim_time, ref_memory);
+        assert_test(saved, "Save prepared state to " + path);
+        if (!saved) return;
+
+        // Each scenario overwrites its own stride of addresses. After restoring, the previous scenario's
+        // writes must be gone and the prepared contents back.
+        const int num_scenarios = 4;
+        bool all_ok = true;
+        std::chrono::duration<double> restore_time(0);
+        for (int scenario = 0; scenario < num_scenarios; scenario++) {
+            auto restore_start = Clock::now();
+            bool restored = restore_checkpoint(path, dut, sim_time, ref_memory);
+            restore_time += Clock::now() - restore_start;
+            if (!restored) {
+                all_ok = false;
+                break;
+            }
+
+            if (scenario > 0) {
+                for (int addr = scenario - 1; addr < log_depth; addr += 64) {
+                    if (read_port_a(addr) != ref_memory[addr]) all_ok = false;
+                }
+            }
+            for (int addr = scenario; addr < log_depth; addr += 64) {
+                write_port_a(addr, ~(addr * 0x3B + 0x11));
+            }
+            tick(1);
+            for (int addr = 0; addr < log_depth; addr += 7) {
+                if (read_port_a(addr) != ref_memory[addr]) all_ok = false;
+            }
+        }
+        std::remove(path.c_str());
+
+        assert_test(all_ok, std::to_string(num_scenarios) + " scenarios from the restored state");
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "Warm-up: " << warm_cycles << " cycles, " << warm_time.count() * 1000 << " ms" << std::endl;
+        std::cout << "Restore: " << restore_time.count() * 1000 / num_scenarios << " ms per scenario"
+                  << std::defaultfloat << std::endl;
+    }
+
+    // Test 14: Backdoor preload and dump. The whole memory is filled without simulating a cycle, checked
+    // through the ports, and port writes are checked with a dump instead of reading them back.
+    void test_backdoor_preload_dump() {
+        std::cout << "\n--- Test 14: Backdoor Preload/Dump ---" << std::endl;
+        dut_reset();
+        reset_ports();
+
+        uint32_t mask = (1u << log_width) - 1;
+        std::vector<uint64_t> words(log_depth);
+        for (int addr = 0; addr < log_depth; addr++) {
+            words[addr] = (addr * 0x2D + 0x5) & mask;
+            ref_memory[addr] = words[addr];
+        }
+        uint64_t start_cycle = sim_time;
+        bool preloaded = preload(0, words);
+        uint64_t preload_cycles = sim_time - start_cycle;
+        assert_test(preloaded && preload_cycles == 0, "Preload " + std::to_string(log_depth) + " words",
+                    std::to_string(preload_cycles) + " cycles (" + std::to_string(log_depth) +
+                    " through a port)");
+        if (!preloaded) return;
+
+        bool reads_ok = true;
+        for (int addr = 0; addr < log_depth && reads_ok; addr += 5) {
+            reads_ok = read_port_a(addr) == words[addr];
+        }
+        assert_test(reads_ok, "Port reads see the preloaded words");
+
+        for (int addr = 3; addr < log_depth; addr += 11) {
+            write_port_a(addr, ~words[addr]);
+        }
+        tick(READ_LATENCY);
+        std::vector<uint64_t> dump = m20k_backdoor_dump(dut, 0, log_depth);
+        bool dump_ok = dump.size() == (size_t)log_depth;
+        for (int addr = 0; addr < log_depth && dump_ok; addr++) {
+            dump_ok = dump[addr] == ref_memory[addr];
+        }
+        assert_test(dump_ok, "Dump matches the reference after port writes");
+
+        // A dump written as a $readmemh file can be loaded with INIT_FILE
+        const std::string path = "m20k_dump.hex";
+        bool file_ok = write_hex_file(path, dump, log_width) && read_hex_file(path) == dump;
+        std::remove(path.c_str());
+        assert_test(file_ok, "Dump round trips through a $readmemh file");
+    }
+
+    // Test 15: Trace record and replay. A random dual-port stream is recorded with its outputs, then
+    // replayed from the trace file onto the same starting contents and checked against them.
+    void test_trace_record_replay() {
+        std::cout << "\n--- Test 15: Stimulus Trace Record/Replay ---" << std::endl;
+        const std::string path = "m20k_stimulus.trc";
+        const int num_cycles = 20000;
+        uint32_t mask = (1u << log_width) - 1;
+
+        std::vector<uint64_t> contents(log_depth);
+        for (int addr = 0; addr < log_depth; addr++) contents[addr] = (addr * 0x19 + 0x3) & mask;
+        preload(0, contents);
+        dut_reset();
+        reset_ports();
+
+        // Bursts of accesses separated by idle stretches, as a real access stream would have
+        std::mt19937 rng(7);
+        TraceWriter writer;
+        bool ok = writer.open(path, trace_field_names(), NUM_TRACE_OUTPUTS);
+        for (int cycle = 0; cycle < num_cycles && ok; cycle++) {
+            bool active = (cycle / 64) % 2 == 0;
+            dut->wen_a = active && (rng() % 4 == 0);
+            dut->ren_a = active && !dut->wen_a;
+            dut->addr_a = rng() % log_depth;
+            dut->data_in_a = rng() & mask;
+            dut->ren_b = active && (rng() % 2 == 0);
+            dut->addr_b = (dut->addr_b + 1) % log_depth;
+            tick();
+            // Inputs as the edge sampled them, outputs as it left them
+            uint64_t fields[NUM_TRACE_FIELDS];
+            get_trace_fields(dut, fields);
+            writer.record(fields);
+        }
+        uint64_t bytes = writer.close();
+        reset_ports();
+
+        preload(0, contents);
+        dut_reset();
+        TraceReader reader;
+        TraceReplayResult replayed;
+        double rate = 0;
+        if (ok && reader.open(path) && reader.field_names() == trace_field_names() &&
+            reader.num_outputs() == NUM_TRACE_OUTPUTS) {
+            rate = measure_cycles_per_second(reader.cycles(), [&] {
+                replayed = replay_trace_checked(clock, reader, apply_trace_fields, get_trace_outputs,
+                                                [this](const uint64_t* f) { apply_backdoor_row(f); });
+            });
+            sim_time += replayed.cycles;
+        }
+        reset_ports();
+        std::remove(path.c_str());
+
+        assert_test(replayed.cycles == (uint64_t)num_cycles && replayed.mismatches == 0,
+                    "Replay of " + std::to_string(num_cycles) + " recorded cycles matches the recorded outputs",
+                    std::to_string(replayed.mismatches) + " cycles differ");
+        std::cout << std::fixed << std::setprecision(2) << "Trace: " << bytes << " bytes, "
+                  << (double)bytes / num_cycles << " bytes/cycle (" << NUM_TRACE_FIELDS * 8
+                  << " uncompressed), replayed at " << std::setprecision(0) << rate << " cycles/s"
+                  << std::defaultfloat << std::endl;
+    }
+
+    // Fixed simulation-speed workload for make bench: passes that fill the memory on port A and read it
+    // all back on port B, one access per cycle through ClockDriver::run()
+    BenchResult run_benchmark() {
+        dut_reset();
+        reset_ports();
+        uint32_t data_mask = (1 << log_width) - 1;
+        const int passes = 256;
+        std::vector<CycleStim> stimulus;
+        stimulus.reserve(passes * 2 * log_depth + READ_LATENCY);
+        for (int pass = 0; pass < passes; pass++) {
+            for (int addr = 0; addr < log_depth; addr++) {
+                stimulus.push_back({1, 0, (uint32_t)addr, 0, (uint32_t)(addr * 0x9E37 + pass * 0x55) & data_mask});
+            }
+            for (int addr = 0; addr < log_depth; addr++) {
+                stimulus.push_back({0, 1, 0, (uint32_t)addr, 0});
+            }
+        }
+        for (int i = 0; i < READ_LATENCY; i++) stimulus.push_back({0, 0, 0, 0, 0});
+
+        BenchResult result;
+        result.benchmark = "m20k_fill_read";
+        result.config = std::to_string(log_width) + "x" + std::to_string(log_depth);
+        result.cycles = stimulus.size();
+        result.ops = uint64_t(passes) * 2 * log_depth;
+        std::vector<uint32_t> outputs;
+        auto start = std::chrono::steady_clock::now();
+        clock.run(stimulus, outputs, apply_stim, capture_out);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        sim_time += stimulus.size();
+        reset_ports();
+        result.seconds = elapsed.count();
+        result.rss_kb = peak_rss_kb();
+        return result;
+    }
+
+    // Replay a trace file instead of running the tests, check the outputs against the recorded ones and
+    // report the simulation rate. The trace is replayed from the freshly constructed model, like the
+    // recording started. Returns whether every cycle matched.
+    bool replay_trace_file(const std::string& path) {
+        TraceReader reader;
+        if (!reader.open(path)) {
+            std::cout << "Can't read trace " << path << std::endl;
+            return false;
+        }
+        if (reader.field_names() != trace_field_names() || reader.num_outputs() != NUM_TRACE_OUTPUTS) {
+            std::cout << path << " wasn't recorded from the M20K ports" << std::endl;
+            return false;
+        }
+        TraceReplayResult replayed;
+        double rate = measure_cycles_per_second(reader.cycles(), [&] {
+            replayed = replay_trace_checked(clock, reader, apply_trace_fields, get_trace_outputs,
+                                            [this](const uint64_t* f) { apply_backdoor_row(f); });
+        });
+        sim_time += replayed.cycles;
+        std::cout << "Replayed " << replayed.cycles << " cycles from " << path << " (" << reader.file_size()
+                  << " bytes) at " << std::fixed << std::setprecision(0) << rate << " cycles/s"
+                  << std::defaultfloat << std::endl;
+        if (replayed.mismatches > 0) {
+            std::cout << "✗ Outputs differ from the recording in " << replayed.mismatches << " cycles, first at cycle "
+                      << replayed.first_mismatch << std::endl;
+            return false;
+        }
+        std::cout << "✓ Outputs match the recording" << std::endl;
+        return true;
+    }
+
     // =============== HELPER FUNCTIONS ===============
+
+    // Stimulus trace fields, in the order of trace_field_names(): the input ports, the address and data
+    // of a backdoor write (only set in the unclocked rows that record one), then the output ports
+    static const int NUM_TRACE_FIELDS = 17;
+    static const int NUM_TRACE_OUTPUTS = 2;
+
+    static std::vector<std::string> trace_field_names() {
+        return {"rst", "addr_a", "data_in_a", "be_a", "wen_a", "ren_a", "burst_a",
+                "addr_b", "data_in_b", "be_b", "wen_b", "ren_b", "burst_b",
+                "backdoor_addr", "backdoor_data", "data_out_a", "data_out_b"};
+    }
+
+    static void get_trace_fields(const Vm20k_bram_core* d, uint64_t* f) {
+        f[0] = d->rst;
+        f[1] = d->addr_a; f[2] = d->data_in_a; f[3] = d->be_a;
+        f[4] = d->wen_a; f[5] = d->ren_a; f[6] = d->burst_a;
+        f[7] = d->addr_b; f[8] = d->data_in_b; f[9] = d->be_b;
+        f[10] = d->wen_b; f[11] = d->ren_b; f[12] = d->burst_b;
+        f[13] = 0; f[14] = 0;
+        get_trace_outputs(d, f + 15);
+    }
+
+    static void get_trace_outputs(const Vm20k_bram_core* d, uint64_t* o) {
+        o[0] = d->data_out_a;
+        o[1] = d->data_out_b;
+    }
+
+    static void apply_trace_fields(Vm20k_bram_core* d, const uint64_t* f) {
+        d->rst = f[0];
+        d->addr_a = f[1]; d->data_in_a = f[2]; d->be_a = f[3];
+        d->wen_a = f[4]; d->ren_a = f[5]; d->burst_a = f[6];
+        d->addr_b = f[7]; d->data_in_b = f[8]; d->be_b = f[9];
+        d->wen_b = f[10]; d->ren_b = f[11]; d->burst_b = f[12];
+    }
+
+    void apply_backdoor_row(const uint64_t* f) {
+        m20k_backdoor_preload(dut, f[13], {f[14]});
+    }
+
+    // Backdoor preload, recorded as unclocked trace rows (one per word) while recording
+    bool preload(uint32_t base, const std::vector<uint64_t>& words) {
+        bool ok = m20k_backdoor_preload(dut, base, words);
+        if (ok && recorder.is_open()) {
+            uint64_t fields[NUM_TRACE_FIELDS];
+            get_trace_fields(dut, fields);
+            for (size_t i = 0; i < words.size(); i++) {
+                fields[13] = base + i;
+                fields[14] = words[i];
+                recorder.record_unclocked(fields);
+            }
+        }
+        return ok;
+    }
     
     void write_port_a(uint32_t addr, uint32_t data) {
         // Mask data to logical width for normal operations
@@ -475,29 +1223,46 @@ public:
 
     // =============== TEST RUNNER ===============
     
+    // Run one test and report the port traffic it generated
+    template<typename Test>
+    void measured(const std::string& name, Test test) {
+        perf.begin(name);
+        test();
+        perf.report();
+    }
+
     void run_core_tests() {
         std::cout << "Starting Core Functionality Tests..." << std::endl;
         
-        test_basic_single_port_rw();
-        test_address_boundaries();  
-        test_data_patterns();
-        test_dual_port_independent();
-        test_data_width_handling();
-        test_same_address_access();
+        measured("basic_single_port_rw", [&] { test_basic_single_port_rw(); });
+        measured("address_boundaries", [&] { test_address_boundaries(); });
+        measured("data_patterns", [&] { test_data_patterns(); });
+        measured("dual_port_independent", [&] { test_dual_port_independent(); });
+        measured("data_width_handling", [&] { test_data_width_handling(); });
+        measured("same_address_access", [&] { test_same_address_access(); });
+        measured("activity_counters", [&] { test_activity_counters(); });
+        measured("row_interleave", [&] { test_row_interleave(); });
+        measured("burst_read", [&] { test_burst_read(); });
+        measured("byte_enables", [&] { test_byte_enables(); });
+        measured("read_latency", [&] { test_read_latency(); });
+        measured("sim_speed", [&] { test_sim_speed(); });
+        measured("checkpoint_restore", [&] { test_checkpoint_restore(); });
+        measured("backdoor_preload_dump", [&] { test_backdoor_preload_dump(); });
+        measured("trace_record_replay", [&] { test_trace_record_replay(); });
         
         std::cout << "\nCore tests completed!" << std::endl;
     }
 };
 
 // Test different memory configurations
-void test_memory_configurations() {
+void test_memory_configurations(const TraceOptions& trace) {
     std::cout << "\n\n=============== TESTING MEMORY CONFIGURATIONS ===============" << std::endl;
     
     // Configuration 1: 8x2048 (default)
     if (LOG_WIDTH == 8 && LOG_DEPTH == 2048)
     {
         std::cout << "\n### Testing 8x2048 Configuration ###" << std::endl;
-        M20kTester tester_8x2048(8, 2048);
+        M20kTester tester_8x2048(8, 2048, trace.record_path);
         tester_8x2048.run_core_tests();
     }
 
@@ -505,7 +1270,7 @@ void test_memory_configurations() {
     else if (LOG_WIDTH == 4 && LOG_DEPTH == 4096)
     {
         std::cout << "\n### Testing 4x4096 Configuration ###" << std::endl;
-        M20kTester tester_4x4096(4, 4096);
+        M20kTester tester_4x4096(4, 4096, trace.record_path);
         tester_4x4096.run_core_tests();
     }
 
@@ -513,7 +1278,7 @@ void test_memory_configurations() {
     else if (LOG_WIDTH == 16 && LOG_DEPTH == 1024)
     {
         std::cout << "\n### Testing 16x1024 Configuration ###" << std::endl;
-        M20kTester tester_16x1024(16, 1024);
+        M20kTester tester_16x1024(16, 1024, trace.record_path);
         tester_16x1024.run_core_tests();
     }
     
@@ -522,11 +1287,169 @@ void test_memory_configurations() {
     std::cout << "recompile Verilog with LOG_WIDTH and LOG_DEPTH parameters." << std::endl;
 }
 
-int main() {
+// Random regression case for --regress: random reads and writes on both ports checked against a
+// reference memory. Accesses that would collide on a physical row are turned into idle cycles.
+// Owns its context and DUT so one can run per thread. With checkpoints the worker fills the memory
+// once and every seed restores that snapshot; otherwise a case reads back what earlier cases left.
+class RandomAccessWorker {
+private:
+    struct CycleStim {
+        uint8_t wen_a, ren_a, wen_b, ren_b;
+        uint32_t addr_a, addr_b;
+        uint32_t data_a, data_b;
+    };
+    struct CycleOut {
+        uint32_t data_a, data_b;
+    };
+
+    std::unique_ptr<VerilatedContext> context;
+    std::unique_ptr<Vm20k_bram_core> dut;
+    ClockDriver<Vm20k_bram_core> clock;
+    WorkerCheckpoint checkpoint;
+
+    static void apply(Vm20k_bram_core* d, const CycleStim& s) {
+        d->wen_a = s.wen_a;
+        d->ren_a = s.ren_a;
+        d->addr_a = s.addr_a;
+        d->data_in_a = s.data_a;
+        d->wen_b = s.wen_b;
+        d->ren_b = s.ren_b;
+        d->addr_b = s.addr_b;
+        d->data_in_b = s.data_b;
+    }
+
+    static void capture(Vm20k_bram_core* d, CycleOut& o) {
+        o.data_a = d->data_out_a;
+        o.data_b = d->data_out_b;
+    }
+
+public:
+    RandomAccessWorker()
+        : context(new VerilatedContext), dut(new Vm20k_bram_core(context.get())), clock(dut.get()),
+          checkpoint("m20k_regress_worker") {
+        dut->rst = 0;
+        dut->be_a = (1u << ((LOG_WIDTH + 7) / 8)) - 1;
+        dut->be_b = dut->be_a;
+        dut->burst_a = 0;
+        dut->burst_b = 0;
+        dut->wen_a = dut->ren_a = dut->wen_b = dut->ren_b = 0;
+        dut->rst = 1;
+        clock.tick();
+        dut->rst = 0;
+        clock.tick();
+
+        if (CHECKPOINTS_AVAILABLE) {
+            // Known contents in every word, saved along with the reference
+            std::map<uint32_t, uint32_t> ref;
+            std::vector<CycleStim> fill;
+            for (uint32_t addr = 0; addr < (uint32_t)LOG_DEPTH; addr++) {
+                uint32_t data = (addr * 0x3B + 0x11) & ((1u << LOG_WIDTH) - 1);
+                fill.push_back({1, 0, 0, 0, addr, 0, data, 0});
+                ref[addr] = data;
+            }
+            for (int i = 0; i < READ_LATENCY; i++) fill.push_back({0, 0, 0, 0, 0, 0, 0, 0});
+            std::vector<CycleOut> fill_out;
+            clock.run(fill, fill_out, apply, capture);
+            checkpoint.save(dut.get(), ref);
+        }
+    }
+
+    bool run_case(uint64_t seed, uint64_t& cycles) {
+        std::mt19937_64 rng(seed);
+        const int num_cycles = 4096;
+        const uint32_t data_mask = (1u << LOG_WIDTH) - 1;
+        const int words_per_row = 160 / LOG_WIDTH;
+        // Keep the addresses in a small window so reads often hit written data
+        const uint32_t window = std::min(LOG_DEPTH, 256);
+        const uint32_t base = rng() % (LOG_DEPTH - window + 1);
+
+        // Start from the worker's snapshot, or else from what earlier cases left in the window, which
+        // has to be read back first
+        std::map<uint32_t, uint32_t> ref;
+        std::vector<CycleStim> preload_stim;
+        if (!checkpoint.restore(dut.get(), ref)) {
+            for (uint32_t addr = base; addr < base + window; addr++) {
+                preload_stim.push_back({0, 1, 0, 0, addr, 0, 0, 0});
+            }
+            for (int i = 0; i < READ_LATENCY; i++) preload_stim.push_back({0, 0, 0, 0, 0, 0, 0, 0});
+            std::vector<CycleOut> preload_out;
+            clock.run(preload_stim, preload_out, apply, capture);
+            for (uint32_t i = 0; i < window; i++) {
+                ref[base + i] = preload_out[i + READ_LATENCY - 1].data_a & data_mask;
+            }
+        }
+
+        // Expected data of each read, keyed by the cycle whose edge puts it on the port
+        std::vector<CycleStim> random_stim;
+        std::map<size_t, uint32_t> expect_a, expect_b;
+        for (int i = 0; i < num_cycles; i++) {
+            CycleStim s = {0, 0, 0, 0, 0, 0, 0, 0};
+            int op_a = rng() % 3, op_b = rng() % 3;   // 0 idle, 1 write, 2 read
+            s.addr_a = base + rng() % window;
+            s.addr_b = base + rng() % window;
+            if (op_a && op_b && (op_a == 1 || op_b == 1) && s.addr_a / words_per_row == s.addr_b / words_per_row) {
+                op_b = 0;
+            }
+            s.wen_a = op_a == 1;
+            s.ren_a = op_a == 2;
+            s.wen_b = op_b == 1;
+            s.ren_b = op_b == 2;
+            s.data_a = rng() & data_mask;
+            s.data_b = rng() & data_mask;
+            random_stim.push_back(s);
+
+            // Reads see the array before this cycle's writes land
+            if (s.ren_a) expect_a[i + READ_LATENCY - 1] = ref[s.addr_a];
+            if (s.ren_b) expect_b[i + READ_LATENCY - 1] = ref[s.addr_b];
+            if (s.wen_a) ref[s.addr_a] = s.data_a;
+            if (s.wen_b) ref[s.addr_b] = s.data_b;
+        }
+        for (int i = 0; i < READ_LATENCY; i++) random_stim.push_back({0, 0, 0, 0, 0, 0, 0, 0});
+
+        std::vector<CycleOut> outputs;
+        clock.run(random_stim, outputs, apply, capture);
+        cycles += preload_stim.size() + random_stim.size();
+
+        for (auto& e : expect_a) {
+            if ((outputs[e.first].data_a & data_mask) != e.second) return false;
+        }
+        for (auto& e : expect_b) {
+            if ((outputs[e.first].data_b & data_mask) != e.second) return false;
+        }
+        return true;
+    }
+};
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    // --regress[=seeds] [--threads=N] [--seed=S] runs seeded random cases in parallel instead of the suite
+    RegressionOptions regress = parse_regression_args(argc, argv);
+    if (regress.enabled) {
+        bool ok = run_parallel_regression<RandomAccessWorker>(
+            "random dual-port accesses (" + std::to_string(LOG_WIDTH) + "x" + std::to_string(LOG_DEPTH) + ")",
+            regress);
+        return ok ? 0 : 1;
+    }
+
+    // --bench runs the fixed simulation-speed workload (see sim_benchmark.h for the other --bench-* flags)
+    BenchOptions bench = parse_bench_args(argc, argv);
+    if (bench.enabled) {
+        M20kTester tester(LOG_WIDTH, LOG_DEPTH);
+        return report_bench(bench, tester.run_benchmark()) ? 0 : 1;
+    }
+
+    // --replay-trace=path replays a recorded stimulus trace, --record-trace=path records the suite's
+    TraceOptions trace = parse_trace_args(argc, argv);
+    if (!trace.replay_path.empty()) {
+        M20kTester tester(LOG_WIDTH, LOG_DEPTH);
+        return tester.replay_trace_file(trace.replay_path) ? 0 : 1;
+    }
+
     std::cout << "M20K BRAM Comprehensive Test Suite" << std::endl;
     std::cout << "===================================" << std::endl;
     
-    test_memory_configurations();
+    test_memory_configurations(trace);
     
     std::cout << "\n=== All Tests Complete ===" << std::endl;
     return 0;
@@ -0,0 +1,368 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <verilated.h>
+#include "Vm20k_cascade.h"
+#include "backdoor.h"
+#include "clock_driver.h"
+
+// This file contains tests for the M20K cascade wrapper at rtl/baseline/m20k_cascade.v
+
+// Change these when compiling the rtl with a different cascade configuration
+const int BLOCK_WIDTH = 8;
+const int BLOCK_DEPTH = 2048;
+const int NUM_WIDE = 2;
+const int NUM_DEEP = 2;
+const int OUT_MUX_REG = 1;
+// Registers of each block, set by make from M20K_REG_INPUTS/M20K_REG_OUTPUTS
+#ifdef TB_REG_INPUTS
+const int REG_INPUTS = TB_REG_INPUTS;
+#else
+const int REG_INPUTS = 1;
+#endif
+#ifdef TB_REG_OUTPUTS
+const int REG_OUTPUTS = TB_REG_OUTPUTS;
+#else
+const int REG_OUTPUTS = 1;
+#endif
+
+// Cascade width must fit in 64 bits for this testbench
+const int CASCADE_WIDTH = NUM_WIDE * BLOCK_WIDTH;
+const int CASCADE_DEPTH = NUM_DEEP * BLOCK_DEPTH;
+const int LANES_PER_BLOCK = (BLOCK_WIDTH + 7) / 8;
+// m20k_bram_core's registers, plus the optional register after the depth mux
+const int READ_LATENCY = REG_INPUTS + REG_OUTPUTS + OUT_MUX_REG;
+
+class CascadeTester {
+private:
+    Vm20k_cascade* dut;
+    vluint64_t sim_time;
+    int test_count;
+    int pass_count;
+    int fail_count;
+    ClockDriver<Vm20k_cascade> clock;
+
+public:
+    CascadeTester()
+        : dut(new Vm20k_cascade()), sim_time(0), test_count(0), pass_count(0), fail_count(0), clock(dut) {
+        reset_ports();
+        std::cout << "=== M20K Cascade Tester Initialized ===" << std::endl;
+        std::cout << "Blocks: " << NUM_WIDE << " wide x " << NUM_DEEP << " deep of "
+                  << BLOCK_WIDTH << "x" << BLOCK_DEPTH << std::endl;
+        std::cout << "Logical memory: " << CASCADE_WIDTH << "x" << CASCADE_DEPTH
+                  << ", read latency " << READ_LATENCY << " cycles" << std::endl;
+    }
+
+    ~CascadeTester() {
+        delete dut;
+        print_summary();
+    }
+
+    uint64_t data_mask() {
+        return CASCADE_WIDTH >= 64 ? ~0ULL : ((1ULL << CASCADE_WIDTH) - 1);
+    }
+
+    uint32_t all_lanes() {
+        return (1u << (NUM_WIDE * LANES_PER_BLOCK)) - 1;
+    }
+
+    void reset_ports() {
+        dut->clk = 0;
+        dut->rst = 0;
+        dut->addr_a = 0;
+        dut->data_in_a = 0;
+        dut->be_a = all_lanes();
+        dut->wen_a = 0;
+        dut->ren_a = 0;
+        dut->addr_b = 0;
+        dut->data_in_b = 0;
+        dut->be_b = all_lanes();
+        dut->wen_b = 0;
+        dut->ren_b = 0;
+    }
+
+    void tick() {
+        clock.tick();
+        sim_time++;
+    }
+
+    void tick(int n) {
+        for (int i = 0; i < n; i++) tick();
+    }
+
+    void dut_reset() {
+        dut->rst = 1;
+        tick();
+        dut->rst = 0;
+        tick();
+    }
+
+    void assert_test(bool condition, const std::string& test_name, const std::string& details = "") {
+        test_count++;
+        if (condition) pass_count++;
+        else fail_count++;
+        std::cout << (condition ? "[PASS] " : "[FAIL] ") << test_name;
+        if (!details.empty()) std::cout << " - " << details;
+        std::cout << std::endl;
+    }
+
+    void print_summary() {
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "Total Tests: " << test_count << std::endl;
+        std::cout << "Passed: " << pass_count << std::endl;
+        std::cout << "Failed: " << fail_count << std::endl;
+    }
+
+    std::string to_hex(uint64_t value) {
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0') << std::setw((CASCADE_WIDTH + 3) / 4) << value;
+        return ss.str();
+    }
+
+    // =============== HELPER FUNCTIONS ===============
+
+    void write_port_a(uint32_t addr, uint64_t data) {
+        dut->addr_a = addr;
+        dut->data_in_a = data & data_mask();
+        dut->wen_a = 1;
+        tick(1);
+        dut->wen_a = 0;
+    }
+
+    uint64_t read_port_a(uint32_t addr) {
+        dut->addr_a = addr;
+        dut->ren_a = 1;
+        tick(1);
+        dut->ren_a = 0;
+        tick(READ_LATENCY - 1);
+        return dut->data_out_a & data_mask();
+    }
+
+    uint64_t read_port_b(uint32_t addr) {
+        dut->addr_b = addr;
+        dut->ren_b = 1;
+        tick(1);
+        dut->ren_b = 0;
+        tick(READ_LATENCY - 1);
+        return dut->data_out_b & data_mask();
+    }
+
+    // Distinct value per address that exercises every block slice
+    uint64_t pattern(uint32_t addr) {
+        return (0x9E3779B97F4A7C15ULL * (addr + 1)) & data_mask();
+    }
+
+    // =============== CORE TEST FUNCTIONS ===============
+
+    // Test 1: Addresses on both sides of every block boundary
+    void test_block_boundaries() {
+        std::cout << "\n--- Test 1: Block Boundaries ---" << std::endl;
+        dut_reset();
+
+        std::vector<uint32_t> addrs;
+        for (int deep = 0; deep < NUM_DEEP; deep++) {
+            addrs.push_back(deep * BLOCK_DEPTH);
+            addrs.push_back(deep * BLOCK_DEPTH + 1);
+            addrs.push_back((deep + 1) * BLOCK_DEPTH - 1);
+        }
+
+        for (uint32_t addr : addrs) write_port_a(addr, pattern(addr));
+        tick(1);
+
+        for (uint32_t addr : addrs) {
+            uint64_t read_data = read_port_a(addr);
+            assert_test(read_data == pattern(addr), "Boundary addr=" + std::to_string(addr),
+                       "wrote=0x" + to_hex(pattern(addr)) + ", read=0x" + to_hex(read_data));
+        }
+    }
+
+    // Test 2: Read latency includes the output mux stage
+    void test_read_latency() {
+        std::cout << "\n--- Test 2: Read Latency ---" << std::endl;
+        dut_reset();
+
+        uint32_t addr_low = 5;
+        uint32_t addr_high = (NUM_DEEP - 1) * BLOCK_DEPTH + 5;
+        write_port_a(addr_low, 0x1111111111111111ULL);
+        write_port_a(addr_high, 0x2222222222222222ULL);
+        tick(1);
+        read_port_a(addr_low);
+
+        // Issue a single-cycle read and count cycles until the new block's data appears
+        dut->addr_a = addr_high;
+        dut->ren_a = 1;
+        int cycles = 0;
+        while (cycles < 10) {
+            tick(1);
+            cycles++;
+            dut->ren_a = 0;
+            if ((dut->data_out_a & data_mask()) == (0x2222222222222222ULL & data_mask())) break;
+        }
+        assert_test(cycles == READ_LATENCY, "Read latency",
+                   "measured=" + std::to_string(cycles) + ", expected=" + std::to_string(READ_LATENCY));
+    }
+
+    // Test 3: Back-to-back reads that alternate between rows of blocks
+    void test_pipelined_reads() {
+        std::cout << "\n--- Test 3: Pipelined Reads Across Blocks ---" << std::endl;
+        dut_reset();
+
+        std::vector<uint32_t> addrs;
+        for (int i = 0; i < 16; i++) {
+            addrs.push_back((i % NUM_DEEP) * BLOCK_DEPTH + 100 + i);
+        }
+        for (uint32_t addr : addrs) write_port_a(addr, pattern(addr));
+        tick(1);
+
+        // One read per cycle, output of read i arrives READ_LATENCY cycles after it was issued
+        std::vector<uint64_t> results;
+        for (size_t cycle = 0; cycle < addrs.size() + READ_LATENCY; cycle++) {
+            if (cycle < addrs.size()) {
+                dut->addr_a = addrs[cycle];
+                dut->ren_a = 1;
+            } else {
+                dut->ren_a = 0;
+            }
+            tick(1);
+            if (cycle + 1 >= (size_t)READ_LATENCY) results.push_back(dut->data_out_a & data_mask());
+        }
+
+        bool all_match = true;
+        for (size_t i = 0; i < addrs.size(); i++) {
+            if (results[i] != pattern(addrs[i])) {
+                all_match = false;
+                std::cout << "Read " << i << " addr=" << addrs[i] << ": expected=0x" << to_hex(pattern(addrs[i]))
+                          << ", read=0x" << to_hex(results[i]) << std::endl;
+            }
+        }
+        assert_test(all_match, "One read per cycle across " + std::to_string(NUM_DEEP) + " block rows");
+    }
+
+    // Test 4: Both ports on different blocks, and byte enables on one wide slice
+    void test_dual_port_and_lanes() {
+        std::cout << "\n--- Test 4: Dual Port and Byte Enables ---" << std::endl;
+        dut_reset();
+
+        uint32_t addr_a = 7;
+        uint32_t addr_b = (NUM_DEEP - 1) * BLOCK_DEPTH + 9;
+
+        // Simultaneous writes to different blocks
+        dut->addr_a = addr_a;
+        dut->data_in_a = pattern(addr_a);
+        dut->wen_a = 1;
+        dut->addr_b = addr_b;
+        dut->data_in_b = pattern(addr_b);
+        dut->wen_b = 1;
+        tick(1);
+        dut->wen_a = 0;
+        dut->wen_b = 0;
+        tick(1);
+
+        uint64_t read_a = read_port_b(addr_a);
+        uint64_t read_b = read_port_a(addr_b);
+        assert_test(read_a == pattern(addr_a) && read_b == pattern(addr_b), "Simultaneous writes to two blocks",
+                   "read_a=0x" + to_hex(read_a) + ", read_b=0x" + to_hex(read_b));
+
+        // Overwrite only the lanes of the last wide block
+        uint32_t upper_lanes = ((1u << LANES_PER_BLOCK) - 1) << ((NUM_WIDE - 1) * LANES_PER_BLOCK);
+        uint64_t upper_mask = (((1ULL << BLOCK_WIDTH) - 1) << ((NUM_WIDE - 1) * BLOCK_WIDTH)) & data_mask();
+        dut->be_a = upper_lanes;
+        write_port_a(addr_a, ~0ULL);
+        dut->be_a = all_lanes();
+        tick(1);
+
+        uint64_t expected = (pattern(addr_a) & ~upper_mask) | upper_mask;
+        uint64_t read_lanes = read_port_a(addr_a);
+        assert_test(read_lanes == expected, "Byte enables on the last wide block",
+                   "expected=0x" + to_hex(expected) + ", read=0x" + to_hex(read_lanes));
+    }
+
+    // Test 5: The output holds the last read while the address moves to other rows of blocks without a read
+    void test_output_holds() {
+        std::cout << "\n--- Test 5: Output Holds Between Reads ---" << std::endl;
+        dut_reset();
+
+        uint32_t addr_low = 11;
+        uint32_t addr_high = (NUM_DEEP - 1) * BLOCK_DEPTH + 11;
+        write_port_a(addr_low, pattern(addr_low));
+        write_port_a(addr_high, pattern(addr_high));
+        tick(1);
+        // Leave the other row of blocks holding a different word
+        read_port_a(addr_high);
+        uint64_t first = read_port_a(addr_low);
+
+        bool held = first == pattern(addr_low);
+        std::string details = "read=0x" + to_hex(first);
+        for (int cycle = 0; cycle < READ_LATENCY + 3; cycle++) {
+            dut->addr_a = (cycle % 2) ? addr_low : addr_high;
+            tick(1);
+            if ((dut->data_out_a & data_mask()) != pattern(addr_low)) {
+                held = false;
+                details = "cycle " + std::to_string(cycle) + " after the read: 0x" + to_hex(dut->data_out_a & data_mask());
+                break;
+            }
+        }
+        assert_test(held && NUM_DEEP > 1, "data_out holds while the address changes with ren=0", details);
+    }
+
+    // Test 6: Backdoor access picks the block by its INSTANCE_ID. Each block gets its own word at the same
+    // block address, which must come out of its slice and row of blocks through the ports.
+    void test_backdoor_blocks() {
+        std::cout << "\n--- Test 6: Backdoor Per Block ---" << std::endl;
+        dut_reset();
+
+        const uint32_t block_addr = 21;
+        const uint64_t block_mask = (1ULL << BLOCK_WIDTH) - 1;
+        auto block_word = [&](int deep, int wide) { return (0x5Au + 0x11u * (deep * NUM_WIDE + wide)) & block_mask; };
+        bool loaded = true;
+        for (int deep = 0; deep < NUM_DEEP; deep++) {
+            for (int wide = 0; wide < NUM_WIDE; wide++) {
+                loaded &= m20k_backdoor_preload(dut, block_addr, {block_word(deep, wide)}, deep * NUM_WIDE + wide);
+            }
+        }
+        assert_test(loaded, "Every block registered its backdoor scope");
+
+        for (int deep = 0; deep < NUM_DEEP; deep++) {
+            uint64_t expected = 0;
+            for (int wide = 0; wide < NUM_WIDE; wide++) expected |= block_word(deep, wide) << (wide * BLOCK_WIDTH);
+            uint32_t addr = deep * BLOCK_DEPTH + block_addr;
+            uint64_t read = read_port_a(addr);
+            assert_test(read == expected, "Backdoor words of row of blocks " + std::to_string(deep),
+                       "expected=0x" + to_hex(expected) + ", read=0x" + to_hex(read));
+
+            // Written through the port, dumped per block
+            write_port_a(addr, pattern(addr));
+            tick(1);
+            bool dumped = true;
+            for (int wide = 0; wide < NUM_WIDE; wide++) {
+                std::vector<uint64_t> words = m20k_backdoor_dump(dut, block_addr, 1, deep * NUM_WIDE + wide);
+                dumped &= words.size() == 1 && (words[0] & block_mask) == ((pattern(addr) >> (wide * BLOCK_WIDTH)) & block_mask);
+            }
+            assert_test(dumped, "Backdoor dump of row of blocks " + std::to_string(deep) + " per slice");
+        }
+    }
+
+    void run_all_tests() {
+        test_block_boundaries();
+        test_read_latency();
+        test_pipelined_reads();
+        test_dual_port_and_lanes();
+        test_output_holds();
+        test_backdoor_blocks();
+        std::cout << "\nCascade tests completed!" << std::endl;
+    }
+};
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    std::cout << "M20K Cascade Test Suite" << std::endl;
+    std::cout << "=======================" << std::endl;
+
+    CascadeTester tester;
+    tester.run_all_tests();
+
+    std::cout << "\n=== All Tests Complete ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,338 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <verilated.h>
+#include "Vm20k_bram_partial_wordlines.h"
+#include "clock_driver.h"
+#include "energy_model.h"
+
+// This file contains tests for the bit-transpose port of the partial-wordline M20K at
+// rtl/m20k_bram_partial_wordlines.v
+
+// Bit tile the rtl was compiled with, set by make from BIT_TILE_ROWS/BIT_TILE_COLS (e.g. 128 x 160)
+#ifdef TB_BIT_TILE_ROWS
+const int BIT_TILE_ROWS = TB_BIT_TILE_ROWS;
+#else
+const int BIT_TILE_ROWS = 40;
+#endif
+#ifdef TB_BIT_TILE_COLS
+const int BIT_TILE_COLS = TB_BIT_TILE_COLS;
+#else
+const int BIT_TILE_COLS = 40;
+#endif
+// Registers the rtl was compiled with, set by make from M20K_REG_INPUTS/M20K_REG_OUTPUTS
+#ifdef TB_REG_INPUTS
+const int REG_INPUTS = TB_REG_INPUTS;
+#else
+const int REG_INPUTS = 1;
+#endif
+#ifdef TB_REG_OUTPUTS
+const int REG_OUTPUTS = TB_REG_OUTPUTS;
+#else
+const int REG_OUTPUTS = 1;
+#endif
+const int READ_LATENCY = REG_INPUTS + REG_OUTPUTS;
+
+// bram_mem registers of the baseline engine (circulant_barrel_shifter_v2) the throughput is compared with,
+// set by make from BRAM_REG_INPUTS/BRAM_REG_OUTPUT like for the engine build
+#ifdef TB_BRAM_REG_INPUTS
+const int BASELINE_BRAM_REG_INPUTS = TB_BRAM_REG_INPUTS;
+#else
+const int BASELINE_BRAM_REG_INPUTS = 1;
+#endif
+#ifdef TB_BRAM_REG_OUTPUT
+const int BASELINE_BRAM_REG_OUTPUT = TB_BRAM_REG_OUTPUT;
+#else
+const int BASELINE_BRAM_REG_OUTPUT = 1;
+#endif
+// Engine read latency: input registers, bank address, the BRAM, collect stage (as in tb_with_mem_modules)
+const int BASELINE_READ_LATENCY = 3 + BASELINE_BRAM_REG_INPUTS + BASELINE_BRAM_REG_OUTPUT;
+
+typedef std::vector<std::vector<uint8_t>> BitTile;   // [row][col], one bit per entry
+
+class PartialWordlineTester {
+private:
+    Vm20k_bram_partial_wordlines* dut;
+    vluint64_t sim_time;
+    static const int PHYS_WIDTH = 160;
+    static const int WDATA_WORDS = (PHYS_WIDTH + 31) / 32;   // bit_wdata is a full physical row wide
+    int test_count;
+    int pass_count;
+    int fail_count;
+    std::mt19937 rng;
+    ClockDriver<Vm20k_bram_partial_wordlines> clock;
+
+public:
+    PartialWordlineTester()
+        : dut(new Vm20k_bram_partial_wordlines()), sim_time(0), test_count(0), pass_count(0), fail_count(0),
+          rng(42), clock(dut) {
+        reset_ports();
+        std::cout << "=== Partial-Wordline M20K Tester Initialized ===" << std::endl;
+        std::cout << "Bit tile: " << BIT_TILE_ROWS << " rows x " << BIT_TILE_COLS << " cols"
+                  << ", read latency " << READ_LATENCY << " cycles" << std::endl;
+    }
+
+    ~PartialWordlineTester() {
+        delete dut;
+        print_summary();
+    }
+
+    void reset_ports() {
+        dut->clk = 0;
+        dut->rst = 0;
+        dut->wen_a = 0;
+        dut->ren_a = 0;
+        dut->burst_a = 0;
+        dut->wen_b = 0;
+        dut->ren_b = 0;
+        dut->burst_b = 0;
+        dut->bit_wen = 0;
+        dut->bit_ren = 0;
+        dut->bit_waddr = 0;
+        dut->bit_raddr = 0;
+        for (int word = 0; word < WDATA_WORDS; word++) dut->bit_wdata[word] = 0;
+    }
+
+    void tick() {
+        clock.tick();
+        sim_time++;
+    }
+
+    void tick(int n) {
+        for (int i = 0; i < n; i++) tick();
+    }
+
+    void dut_reset() {
+        dut->rst = 1;
+        tick();
+        dut->rst = 0;
+        tick();
+    }
+
+    void assert_test(bool condition, const std::string& test_name, const std::string& details = "") {
+        test_count++;
+        if (condition) pass_count++;
+        else fail_count++;
+        std::cout << (condition ? "[PASS] " : "[FAIL] ") << test_name;
+        if (!details.empty()) std::cout << " - " << details;
+        std::cout << std::endl;
+    }
+
+    void print_summary() {
+        std::cout << "\n=== Test Summary ===" << std::endl;
+        std::cout << "Total Tests: " << test_count << std::endl;
+        std::cout << "Passed: " << pass_count << std::endl;
+        std::cout << "Failed: " << fail_count << std::endl;
+    }
+
+    // =============== HELPER FUNCTIONS ===============
+
+    BitTile random_tile() {
+        BitTile tile(BIT_TILE_ROWS, std::vector<uint8_t>(BIT_TILE_COLS));
+        for (auto& row : tile) {
+            for (auto& bit : row) bit = rng() & 1;
+        }
+        return tile;
+    }
+
+    // Drive a tile row onto the write port for the next edge
+    void set_write_row(int row, const std::vector<uint8_t>& bits) {
+        dut->bit_waddr = row;
+        for (int word = 0; word < WDATA_WORDS; word++) dut->bit_wdata[word] = 0;
+        for (int col = 0; col < BIT_TILE_COLS; col++) {
+            if (bits[col]) dut->bit_wdata[col / 32] |= 1u << (col % 32);
+        }
+    }
+
+    // Current transposed read output, one bit per tile row
+    std::vector<uint8_t> get_read_col() {
+        std::vector<uint8_t> bits(BIT_TILE_ROWS);
+        for (int row = 0; row < BIT_TILE_ROWS; row++) {
+            bits[row] = (dut->bit_rdata[row / 32] >> (row % 32)) & 1;
+        }
+        return bits;
+    }
+
+    struct BitOp {
+        bool write;
+        int tile;
+        int index;   // Tile row for writes, tile column for reads
+    };
+
+    // Write each tile then read back all of its columns, one access per cycle with no gaps, including
+    // between tiles. Returns the transposed tiles, and the cycles from the first write to the last data.
+    std::vector<BitTile> transpose_tiles(const std::vector<BitTile>& tiles, uint64_t& cycles) {
+        std::vector<BitOp> ops;
+        for (int tile = 0; tile < (int)tiles.size(); tile++) {
+            for (int row = 0; row < BIT_TILE_ROWS; row++) ops.push_back({true, tile, row});
+            for (int col = 0; col < BIT_TILE_COLS; col++) ops.push_back({false, tile, col});
+        }
+
+        std::vector<BitTile> results(tiles.size(), BitTile(BIT_TILE_COLS));
+        uint64_t start = sim_time;
+        for (size_t cycle = 0; cycle < ops.size() + READ_LATENCY - 1; cycle++) {
+            dut->bit_wen = 0;
+            dut->bit_ren = 0;
+            if (cycle < ops.size()) {
+                const BitOp& op = ops[cycle];
+                if (op.write) {
+                    set_write_row(op.index, tiles[op.tile][op.index]);
+                    dut->bit_wen = 1;
+                } else {
+                    dut->bit_raddr = op.index;
+                    dut->bit_ren = 1;
+                }
+            }
+            tick();
+            // The access issued READ_LATENCY - 1 cycles ago has its data on the output now
+            if (cycle + 1 >= (size_t)READ_LATENCY) {
+                const BitOp& done = ops[cycle + 1 - READ_LATENCY];
+                if (!done.write) results[done.tile][done.index] = get_read_col();
+            }
+        }
+        dut->bit_wen = 0;
+        dut->bit_ren = 0;
+        cycles = sim_time - start;
+        return results;
+    }
+
+    // Row k of the result must be column k of the tile
+    bool check_transpose(const BitTile& tile, const BitTile& result, std::string& details) {
+        for (int col = 0; col < BIT_TILE_COLS; col++) {
+            for (int row = 0; row < BIT_TILE_ROWS; row++) {
+                if (result[col][row] != tile[row][col]) {
+                    details = "transposed row " + std::to_string(col) + " bit " + std::to_string(row) +
+                              ": expected " + std::to_string(tile[row][col]) + ", read " +
+                              std::to_string(result[col][row]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // =============== TESTS ===============
+
+    // Test 1: Transpose one random tile and a few structured ones
+    void test_bit_transpose() {
+        std::cout << "\n--- Test 1: Bit Tile Transpose ---" << std::endl;
+        dut_reset();
+
+        BitTile identity(BIT_TILE_ROWS, std::vector<uint8_t>(BIT_TILE_COLS, 0));
+        BitTile first_col(BIT_TILE_ROWS, std::vector<uint8_t>(BIT_TILE_COLS, 0));
+        for (int row = 0; row < BIT_TILE_ROWS; row++) {
+            identity[row][row] = 1;
+            first_col[row][0] = 1;
+        }
+
+        std::vector<std::pair<std::string, BitTile>> cases = {
+            {"Random tile", random_tile()},
+            {"Identity", identity},
+            {"Single set column", first_col},
+        };
+        for (auto& tc : cases) {
+            uint64_t cycles;
+            auto results = transpose_tiles({tc.second}, cycles);
+            std::string details;
+            bool ok = check_transpose(tc.second, results[0], details);
+            assert_test(ok, tc.first + " " + std::to_string(BIT_TILE_ROWS) + "x" + std::to_string(BIT_TILE_COLS),
+                        details);
+        }
+    }
+
+    // Test 2: Array activity of one tile. A row write is one wordline, a transposed read drives one
+    // wordline segment per tile row and senses one bit from each.
+    void test_activity_counters() {
+        std::cout << "\n--- Test 2: Activity Counters ---" << std::endl;
+        dut_reset();
+
+        uint64_t cycles;
+        transpose_tiles({random_tile()}, cycles);
+        tick(2);
+
+        uint64_t bits = uint64_t(BIT_TILE_ROWS) * BIT_TILE_COLS;
+        uint64_t expected_wl = BIT_TILE_ROWS + uint64_t(BIT_TILE_COLS) * BIT_TILE_ROWS;
+        bool ok = dut->wl_activations == expected_wl && dut->bitlines_sensed == bits && dut->cells_written == bits;
+        assert_test(ok, "Counters for one tile",
+                    "wordlines=" + std::to_string(dut->wl_activations) + " (expected " + std::to_string(expected_wl) +
+                    "), sensed=" + std::to_string(dut->bitlines_sensed) + ", written=" +
+                    std::to_string(dut->cells_written) + " (expected " + std::to_string(bits) + ")");
+
+        // Energy from the measured counts, against the closed-form estimate the engine testbench reports
+        ActivityCounts measured = activity_from_bit_tile_counters(dut->wl_activations, dut->bitlines_sensed,
+                                                                  dut->cells_written, BIT_TILE_COLS);
+        print_energy_report("Partial-wordline M20K, bit-transpose port (measured)", measured, bits);
+        if (BIT_TILE_ROWS == BIT_TILE_COLS) {
+            ActivityCounts estimate = partial_wordline_transpose_activity(BIT_TILE_ROWS, 1, 1);
+            bool matches = measured.wl_activations == estimate.wl_activations &&
+                           measured.wl_columns == estimate.wl_columns &&
+                           measured.bitlines_sensed == estimate.bitlines_sensed &&
+                           measured.cells_written == estimate.cells_written;
+            assert_test(matches, "Measured activity matches partial_wordline_transpose_activity()",
+                        "estimated energy " + std::to_string(estimate_energy(estimate)) + ", measured " +
+                        std::to_string(estimate_energy(measured)));
+        }
+    }
+
+    // Test 3: Back-to-back tiles, reported against the baseline engine built with MEM_WIDTH=1
+    void test_throughput() {
+        std::cout << "\n--- Test 3: Throughput vs Baseline ---" << std::endl;
+        dut_reset();
+
+        const int num_tiles = 8;
+        std::vector<BitTile> tiles;
+        for (int i = 0; i < num_tiles; i++) tiles.push_back(random_tile());
+
+        uint64_t cycles;
+        auto results = transpose_tiles(tiles, cycles);
+        bool all_ok = true;
+        std::string details;
+        for (int i = 0; i < num_tiles && all_ok; i++) {
+            all_ok = check_transpose(tiles[i], results[i], details);
+            if (!all_ok) details = "tile " + std::to_string(i) + " " + details;
+        }
+        assert_test(all_ok, std::to_string(num_tiles) + " tiles back to back", details);
+
+        // Estimate for the baseline, which isn't simulated here: square tiles of BIT_TILE_ROWS one-bit
+        // elements with one 1-bit-wide BRAM per column, one row written and one transposed row read per
+        // cycle, tiles back to back, plus the engine's read latency for the last row.
+        uint64_t bits = uint64_t(num_tiles) * BIT_TILE_ROWS * BIT_TILE_COLS;
+        int base_dim = BIT_TILE_ROWS;
+        uint64_t base_tiles = (bits + uint64_t(base_dim) * base_dim - 1) / (uint64_t(base_dim) * base_dim);
+        uint64_t base_cycles = base_tiles * 2 * base_dim + BASELINE_READ_LATENCY - 1;
+
+        double pwl_rate = (double)bits / cycles;
+        double base_rate = (double)bits / base_cycles;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Transposed " << bits << " bits" << std::endl;
+        std::cout << "  Partial-wordline M20K (1 BRAM):  " << cycles << " cycles, " << pwl_rate
+                  << " bits/cycle, " << pwl_rate << " bits/cycle/BRAM" << std::endl;
+        std::cout << "  Baseline engine estimate (not simulated), MEM_WIDTH=1, MATRIX_DIM=" << base_dim << " ("
+                  << base_dim << " BRAMs, read latency " << BASELINE_READ_LATENCY << "): " << base_cycles << " cycles, " << base_rate << " bits/cycle, " << base_rate / base_dim
+                  << " bits/cycle/BRAM" << std::endl;
+        std::cout << "  Estimated speedup: " << pwl_rate / base_rate << "x per cycle, "
+                  << (pwl_rate / base_rate) * base_dim << "x per BRAM" << std::defaultfloat << std::endl;
+    }
+
+    void run_all_tests() {
+        test_bit_transpose();
+        test_activity_counters();
+        test_throughput();
+        std::cout << "\nPartial-wordline tests completed!" << std::endl;
+    }
+};
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    std::cout << "Partial-Wordline M20K Test Suite" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    PartialWordlineTester tester;
+    tester.run_all_tests();
+
+    std::cout << "\n=== All Tests Complete ===" << std::endl;
+    return 0;
+}
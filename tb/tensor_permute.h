@@ -0,0 +1,116 @@
+#ifndef TENSOR_PERMUTE_H
+#define TENSOR_PERMUTE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Tensor axis permutations (e.g. NCHW <-> NHWC) decomposed into tile transposes for the
+// transpose engine. A permutation is supported when it keeps some leading axes in place and swaps
+// the two groups of axes after them, so it is a batch of 2-d transposes:
+//   [batch axes..., row axes..., col axes...] -> [batch axes..., col axes..., row axes...]
+// which covers NCHW->NHWC, NHWC->NCHW, CHW->HWC, HWC->CHW and plain matrix transposes.
+
+// Batched matrix transpose: batch x [rows x cols] -> batch x [cols x rows]
+struct TransposePlan {
+    int batch = 1;
+    int rows = 1;
+    int cols = 1;
+};
+
+// One engine tile: up to tile_dim x tile_dim elements starting at (row0, col0) of a batch entry.
+// Edge tiles are padded with zeros and only the valid part of the result is kept.
+struct TileJob {
+    int batch;
+    int row0;
+    int col0;
+    int valid_rows;
+    int valid_cols;
+};
+
+// perm[i] is the input axis that becomes output axis i
+inline bool plan_batched_transpose(const std::vector<int>& dims, const std::vector<int>& perm,
+                                   TransposePlan& plan, std::string& why) {
+    int n = dims.size();
+    if ((int)perm.size() != n) {
+        why = "permutation rank doesn't match tensor rank";
+        return false;
+    }
+
+    // Leading axes that stay in place form the batch
+    int first_moved = 0;
+    while (first_moved < n && perm[first_moved] == first_moved) first_moved++;
+
+    plan = TransposePlan();
+    for (int axis = 0; axis < first_moved; axis++) plan.batch *= dims[axis];
+    if (first_moved == n) {
+        // Identity: a single row per batch entry, nothing to transpose
+        return true;
+    }
+
+    // The remaining axes must be [split..n-1, first_moved..split-1]
+    int split = perm[first_moved];
+    int expected = split;
+    for (int i = first_moved; i < n; i++) {
+        if (perm[i] != expected) {
+            why = "axis order isn't a swap of two contiguous axis groups";
+            return false;
+        }
+        expected = (expected + 1 == n) ? first_moved : expected + 1;
+    }
+
+    for (int axis = first_moved; axis < split; axis++) plan.rows *= dims[axis];
+    for (int axis = split; axis < n; axis++) plan.cols *= dims[axis];
+    return true;
+}
+
+// Tiles are visited band by band along the input rows, so the input is consumed in order one band of
+// tile_dim rows at a time. Each tile's transposed rows land in tile_dim different output rows, so the
+// output is written per tile at its final location.
+inline std::vector<TileJob> decompose_into_tiles(const TransposePlan& plan, int tile_dim) {
+    std::vector<TileJob> jobs;
+    for (int b = 0; b < plan.batch; b++) {
+        for (int row0 = 0; row0 < plan.rows; row0 += tile_dim) {
+            for (int col0 = 0; col0 < plan.cols; col0 += tile_dim) {
+                TileJob job;
+                job.batch = b;
+                job.row0 = row0;
+                job.col0 = col0;
+                job.valid_rows = std::min(tile_dim, plan.rows - row0);
+                job.valid_cols = std::min(tile_dim, plan.cols - col0);
+                jobs.push_back(job);
+            }
+        }
+    }
+    return jobs;
+}
+
+// Reference: permute a row-major tensor axis by axis, independent of the tile decomposition
+template<typename T>
+std::vector<T> permute_tensor_golden(const std::vector<int>& dims, const std::vector<int>& perm,
+                                     const std::vector<T>& input) {
+    int n = dims.size();
+    std::vector<int> out_dims(n);
+    for (int i = 0; i < n; i++) out_dims[i] = dims[perm[i]];
+
+    // Row-major strides of the input
+    std::vector<size_t> in_strides(n, 1);
+    for (int axis = n - 2; axis >= 0; axis--) in_strides[axis] = in_strides[axis + 1] * dims[axis + 1];
+
+    std::vector<T> output(input.size());
+    std::vector<int> out_idx(n, 0);
+    for (size_t flat = 0; flat < output.size(); flat++) {
+        size_t src = 0;
+        for (int i = 0; i < n; i++) src += out_idx[i] * in_strides[perm[i]];
+        output[flat] = input[src];
+
+        for (int i = n - 1; i >= 0; i--) {
+            if (++out_idx[i] < out_dims[i]) break;
+            out_idx[i] = 0;
+        }
+    }
+    return output;
+}
+
+#endif